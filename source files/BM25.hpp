@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "DocLengths.hpp"
+
+// =================================================================
+// BM25
+// =================================================================
+//
+//   score(d) = sum over matched terms t of
+//              idf(t) * tf * (k1 + 1) / (tf + k1 * (1 - b + b * len(d) / avgLen))
+//   idf(t)   = log(1 + (N - df + 0.5) / (df + 0.5))
+//
+// Each term's TF counts on its own, saturating at k1 + 1 occurrences'
+// worth, and b scales it down in documents longer than average, so a
+// giant document no longer wins on raw occurrence counts.
+//
+// Everything that does not depend on the query is prepared once, before
+// scoring: configure() computes the per-document k1 * (1 - b + b * len /
+// avgLen), precomputeIDF() the IDF of every lexID. Without a length
+// column every document counts as average length (b has no effect) and N
+// falls back to the caller's estimate.
+
+struct BM25Params {
+    float k1 = 1.2f;
+    float b  = 0.75f;
+};
+
+class BM25 {
+public:
+    /**
+     * @brief Prepares the per-document norms. lengths may be null or empty;
+     * N is then fallbackDocuments.
+     */
+    void configure(const DocLengths* lengths, uint32_t fallbackDocuments, BM25Params params) {
+        params_ = params;
+        bool haveLengths = lengths && !lengths->empty();
+        documents_ = haveLengths ? lengths->documents() : fallbackDocuments;
+
+        // Docs without a length (added after indexing: past the column's
+        // end, or a 0 entry inside it) count as average
+        averageNorm_ = params.k1;
+        minNorm_ = averageNorm_;
+        norms_.clear();
+        if (haveLengths) {
+            float avg = lengths->averageLength();
+            norms_.resize(lengths->size());
+            for (uint32_t d = 0; d < lengths->size(); ++d) {
+                uint32_t len = lengths->length(d);
+                norms_[d] = len ? params.k1 * (1.0f - params.b + params.b * len / avg) : averageNorm_;
+                minNorm_ = std::min(minNorm_, norms_[d]);
+            }
+        }
+    }
+
+    const BM25Params& params() const { return params_; }
+    uint32_t documents() const { return documents_; }
+
+    float idf(uint32_t df) const {
+        float n = static_cast<float>(std::min(df, documents_));
+        return std::log(1.0f + (documents_ - n + 0.5f) / (n + 0.5f));
+    }
+
+    /**
+     * @brief Fills the IDF of every lexID from dfs[lexID] (0: no DF entry,
+     * the term then weighs nothing, as before).
+     */
+    void precomputeIDF(const std::vector<uint32_t>& dfs) {
+        idfs_.assign(dfs.size(), 0.0f);
+        for (size_t id = 0; id < dfs.size(); ++id)
+            if (dfs[id]) idfs_[id] = idf(dfs[id]);
+    }
+
+    // Precomputed IDF of lexID; 0 if unknown
+    float termIDF(int lexID) const {
+        return lexID >= 0 && static_cast<size_t>(lexID) < idfs_.size() ? idfs_[lexID] : 0.0f;
+    }
+
+    float norm(uint32_t docID) const { return docID < norms_.size() ? norms_[docID] : averageNorm_; }
+
+    // Contribution of one term occurring tf times in docID
+    float termScore(float idf, uint32_t tf, uint32_t docID) const {
+        float f = static_cast<float>(tf);
+        return idf * (f * (params_.k1 + 1.0f)) / (f + norm(docID));
+    }
+
+    // Upper bound of termScore() over every document, for tf <= maxTF
+    // (the score grows with tf and shrinks with the norm)
+    float termBound(float idf, uint32_t maxTF) const {
+        float f = static_cast<float>(maxTF);
+        return (f == 0.0f) ? 0.0f : idf * (f * (params_.k1 + 1.0f)) / (f + minNorm_);
+    }
+
+private:
+    BM25Params params_;
+    uint32_t documents_ = 0;
+    float averageNorm_ = 1.2f;
+    float minNorm_ = 1.2f;
+    std::vector<float> norms_;   // k1 * (1 - b + b * len / avgLen) per docID
+    std::vector<float> idfs_;    // per lexID
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include "PostingCursor.hpp"
+
+// All posting lists of one barrel, decoded into flat sorted arrays.
+// Term i owns postings [offsets[i], offsets[i+1]) of docIDs / freqs.
+struct DecodedBarrel {
+    std::vector<uint32_t> lexIDs;   // sorted ascending
+    std::vector<uint32_t> offsets;  // lexIDs.size() + 1 entries
+    std::vector<uint32_t> docIDs;
+    std::vector<uint32_t> freqs;
+    std::vector<uint32_t> maxFreqs; // per term, for score bounds (see computeMaxFreqs)
+
+    // Fills maxFreqs once the postings are in place
+    void computeMaxFreqs() {
+        maxFreqs.assign(lexIDs.size(), 0);
+        for (size_t i = 0; i < lexIDs.size(); ++i)
+            for (uint32_t p = offsets[i]; p < offsets[i + 1]; ++p)
+                maxFreqs[i] = std::max(maxFreqs[i], freqs[p]);
+    }
+
+    PostingSpan find(uint32_t lexID) const {
+        PostingSpan span;
+        auto it = std::lower_bound(lexIDs.begin(), lexIDs.end(), lexID);
+        if (it == lexIDs.end() || *it != lexID) return span;
+
+        size_t i = it - lexIDs.begin();
+        span.docIDs = docIDs.data() + offsets[i];
+        span.freqs  = freqs.data() + offsets[i];
+        span.size   = offsets[i + 1] - offsets[i];
+        if (i < maxFreqs.size()) span.maxFreq = maxFreqs[i];
+        return span;
+    }
+
+    size_t bytes() const {
+        return sizeof(DecodedBarrel) +
+               (lexIDs.capacity() + offsets.capacity() + docIDs.capacity() + freqs.capacity() +
+                maxFreqs.capacity()) * sizeof(uint32_t);
+    }
+};
+
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t bytes = 0;
+    size_t budget = 0;
+    size_t entries = 0;
+};
+
+/**
+ * @brief LRU cache of decoded barrels, bounded by a byte budget.
+ * Two query terms from the same barrel share one decode, and repeated
+ * queries are served from memory. Entries are handed out as shared_ptr,
+ * so a barrel evicted mid-query stays valid until the query drops it.
+ * Safe to share between threads; barrels are decoded outside the lock.
+ */
+class BarrelCache {
+public:
+    explicit BarrelCache(size_t budgetBytes = 64u << 20) { stats_.budget = budgetBytes; }
+
+    /**
+     * @brief Returns barrelID from the cache, or calls load(barrelID)
+     * (returning a DecodedBarrel) and caches the result. Two threads
+     * missing the same barrel may both decode it; the first one is kept.
+     */
+    template <typename Loader>
+    std::shared_ptr<const DecodedBarrel> get(int barrelID, Loader&& load) {
+        if (auto barrel = find(barrelID)) return barrel;
+        return insert(barrelID, std::make_shared<const DecodedBarrel>(load(barrelID)));
+    }
+
+    // The cached barrel (now most recently used), or null; counts a hit or a miss
+    std::shared_ptr<const DecodedBarrel> find(int barrelID) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(barrelID);
+        if (it == index_.end()) {
+            stats_.misses++;
+            return nullptr;
+        }
+        stats_.hits++;
+        lru_.splice(lru_.begin(), lru_, it->second); // mark most recently used
+        return it->second->barrel;
+    }
+
+    /**
+     * @brief Caches a barrel decoded by the caller (after a find() miss),
+     * unless it exceeds the whole budget. Returns it either way.
+     */
+    std::shared_ptr<const DecodedBarrel> insert(int barrelID, std::shared_ptr<const DecodedBarrel> barrel) {
+        size_t size = barrel->bytes();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto it = index_.find(barrelID); it != index_.end()) return it->second->barrel;
+        if (size <= stats_.budget) {
+            lru_.push_front({barrelID, barrel, size});
+            index_[barrelID] = lru_.begin();
+            stats_.bytes += size;
+            evictToBudget();
+        }
+        return barrel;
+    }
+
+    void setBudget(size_t budgetBytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.budget = budgetBytes;
+        evictToBudget();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lru_.clear();
+        index_.clear();
+        stats_.bytes = 0;
+    }
+
+    CacheStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CacheStats s = stats_;
+        s.entries = index_.size();
+        return s;
+    }
+
+private:
+    struct Entry {
+        int barrelID;
+        std::shared_ptr<const DecodedBarrel> barrel;
+        size_t bytes;
+    };
+
+    void evictToBudget() {
+        while (stats_.bytes > stats_.budget && !lru_.empty()) {
+            const Entry& victim = lru_.back();
+            stats_.bytes -= victim.bytes;
+            index_.erase(victim.barrelID);
+            lru_.pop_back();
+            stats_.evictions++;
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;
+    std::unordered_map<int, std::list<Entry>::iterator> index_;
+    CacheStats stats_;
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "JsonScanner.hpp"
+
+// =================================================================
+// JSON BARREL SIDECAR (barrel_N.idx)
+// =================================================================
+//
+// Byte ranges of every posting object inside an unchanged barrel_N.json,
+// so one term can be read with a seek + a slice parse instead of parsing
+// the whole barrel. Little-endian:
+//
+//   SidecarHeader
+//   SidecarEntry[termCount]   sorted by lexID
+//
+// The header records the JSON file's size; a sidecar whose size does not
+// match (the barrel was rewritten, e.g. by addDocument) is ignored.
+
+const char     SIDECAR_MAGIC[4] = {'L', 'U', 'M', 'X'};
+const uint32_t SIDECAR_VERSION  = 1;
+
+struct SidecarHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t termCount;
+    uint32_t reserved;
+    uint64_t jsonSize;
+};
+
+struct SidecarEntry {
+    uint32_t lexID;
+    uint32_t length;   // bytes of the posting object text
+    uint64_t offset;   // from the start of barrel_N.json
+};
+
+inline std::string barrelSidecarPath(const std::string& dir, int barrelID) {
+    return dir + "/barrel_" + std::to_string(barrelID) + ".idx";
+}
+
+// -------------------- WRITE --------------------
+/**
+ * @brief Scans jsonPath once and writes its sidecar to idxPath.
+ * @return Number of terms indexed, or -1 on failure.
+ */
+inline long writeBarrelSidecar(const std::string& jsonPath, const std::string& idxPath)
+{
+    JsonFile file;
+    if (!file.open(jsonPath)) {
+        std::cerr << "Warning: Skipping missing barrel " << jsonPath << "\n";
+        return -1;
+    }
+
+    std::vector<SidecarEntry> entries;
+    JsonCursor cur = file.cursor();
+    cur.object([&](std::string_view key, JsonCursor& c) {
+        std::string_view text = c.raw();
+        int lexID;
+        if (!parseKey(key, lexID)) return;
+        entries.push_back({static_cast<uint32_t>(lexID), static_cast<uint32_t>(text.size()),
+                           static_cast<uint64_t>(text.data() - file.data())});
+    });
+    if (!cur.ok()) {
+        std::cerr << "ERROR: Malformed barrel " << jsonPath << "\n";
+        return -1;
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const SidecarEntry& a, const SidecarEntry& b) { return a.lexID < b.lexID; });
+
+    SidecarHeader header{};
+    std::memcpy(header.magic, SIDECAR_MAGIC, 4);
+    header.version = SIDECAR_VERSION;
+    header.termCount = static_cast<uint32_t>(entries.size());
+    header.jsonSize = file.size();
+
+    std::ofstream fout(idxPath, std::ios::binary);
+    if (!fout) {
+        std::cerr << "ERROR: Cannot write sidecar " << idxPath << "\n";
+        return -1;
+    }
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fout.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SidecarEntry));
+    return fout ? static_cast<long>(entries.size()) : -1;
+}
+
+// -------------------- READ --------------------
+/**
+ * @brief Reads the posting object text of lexID from jsonPath via its
+ * sidecar: a table lookup, one seek and one read of just that range.
+ * @return false if there is no usable sidecar (the caller should parse the
+ * barrel itself). On true, slice is the object text, or empty if the
+ * barrel has no entry for lexID.
+ */
+inline bool readBarrelSlice(const std::string& jsonPath, const std::string& idxPath,
+                            uint32_t lexID, std::string& slice)
+{
+    slice.clear();
+
+    std::ifstream idx(idxPath, std::ios::binary);
+    if (!idx) return false;
+
+    SidecarHeader header;
+    if (!idx.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, SIDECAR_MAGIC, 4) != 0 || header.version != SIDECAR_VERSION)
+    {
+        std::cerr << "Warning: Ignoring invalid sidecar " << idxPath << "\n";
+        return false;
+    }
+
+    std::ifstream json(jsonPath, std::ios::binary | std::ios::ate);
+    if (!json || static_cast<uint64_t>(json.tellg()) != header.jsonSize)
+        return false; // barrel changed since the sidecar was built
+
+    std::vector<SidecarEntry> table(header.termCount);
+    if (!idx.read(reinterpret_cast<char*>(table.data()), table.size() * sizeof(SidecarEntry))) {
+        std::cerr << "Warning: Ignoring truncated sidecar " << idxPath << "\n";
+        return false;
+    }
+
+    auto it = std::lower_bound(table.begin(), table.end(), lexID,
+                               [](const SidecarEntry& e, uint32_t id) { return e.lexID < id; });
+    if (it == table.end() || it->lexID != lexID) return true;
+
+    slice.resize(it->length);
+    json.seekg(static_cast<std::streamoff>(it->offset));
+    if (!json.read(&slice[0], slice.size())) {
+        slice.clear();
+        return false;
+    }
+    return true;
+}
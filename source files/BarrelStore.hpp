@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "BinaryBarrel.hpp"
+#include "MappedFile.hpp"
+#include "PostingCursor.hpp"
+
+/**
+ * @brief Maps every barrel_N.bin in a directory once and hands out
+ * PostingSpans. Raw barrels are served zero-copy: lookups never allocate
+ * or touch the disk beyond page faults, and the pages are shared with
+ * other processes serving the same index.
+ */
+class BarrelStore {
+public:
+    /**
+     * @brief Maps barrel_0.bin .. barrel_{totalBarrels-1}.bin from dir.
+     * Missing or invalid barrels are skipped.
+     * @return Number of barrels mapped.
+     */
+    int open(const std::string& dir, int totalBarrels = 32) {
+        files_.clear();
+        files_.resize(totalBarrels);
+        int opened = 0;
+
+        for (int i = 0; i < totalBarrels; ++i) {
+            MappedFile file;
+            if (!file.open(binaryBarrelPath(dir, i))) continue;
+
+            const auto* header = reinterpret_cast<const BarrelHeader*>(file.data());
+            if (file.size() < sizeof(BarrelHeader) ||
+                std::memcmp(header->magic, BARREL_MAGIC, 4) != 0 ||
+                !isKnownBarrelVersion(header->version) ||
+                file.size() < sizeof(BarrelHeader) + header->termCount * sizeof(BarrelTermEntry))
+            {
+                std::cerr << "Warning: Ignoring invalid binary barrel " << binaryBarrelPath(dir, i) << "\n";
+                continue;
+            }
+
+            files_[i] = std::move(file);
+            opened++;
+        }
+        return opened;
+    }
+
+    bool hasBarrel(int barrelID) const {
+        return barrelID >= 0 && barrelID < static_cast<int>(files_.size()) && files_[barrelID].isOpen();
+    }
+
+    bool empty() const {
+        return std::none_of(files_.begin(), files_.end(),
+                            [](const MappedFile& f) { return f.isOpen(); });
+    }
+
+    /**
+     * @brief Returns the postings of lexID in barrelID, or an empty span
+     * if it has none or its block is corrupt.
+     * Raw barrels are served zero-copy from the mapping; compressed barrels
+     * are decoded into scratch and the span points into it, so scratch must
+     * outlive the span. Reusing scratch across queries avoids reallocation.
+     */
+    PostingSpan fetch(int barrelID, uint32_t lexID, BarrelPostings& scratch) const {
+        PostingSpan span;
+        if (!hasBarrel(barrelID)) return span;
+
+        const MappedFile& file = files_[barrelID];
+        const auto* header = reinterpret_cast<const BarrelHeader*>(file.data());
+        const auto* table  = reinterpret_cast<const BarrelTermEntry*>(file.data() + sizeof(BarrelHeader));
+        const BarrelTermEntry* it = findEntry(barrelID, lexID);
+        if (!it) return span;
+
+        if (!blockInFile(*header, table, it, file.size())) return span;
+        const char* block = file.data() + it->offset;
+
+        if (header->version != BARREL_VERSION_RAW) {
+            size_t bytes = barrelBlockSize(*header, table, it - table, file.size());
+            if (!decodeBarrelBlock(header->version, block, bytes, it->length, scratch)) return span;
+            span.docIDs = scratch.docIDs.data();
+            span.freqs  = scratch.freqs.data();
+        } else {
+            span.docIDs = reinterpret_cast<const uint32_t*>(block);
+            span.freqs  = span.docIDs + it->length;
+        }
+        span.size = it->length;
+        return span;
+    }
+
+    /**
+     * @brief Returns a cursor over the postings of lexID in barrelID.
+     * Block-format barrels are iterated in place, decoding one 128-posting
+     * block at a time and skipping blocks on advance(); other formats go
+     * through fetch() and scratch.
+     */
+    PostingCursor cursor(int barrelID, uint32_t lexID, BarrelPostings& scratch) const {
+        if (hasBarrel(barrelID)) {
+            const MappedFile& file = files_[barrelID];
+            const auto* header = reinterpret_cast<const BarrelHeader*>(file.data());
+            if (header->version == BARREL_VERSION_BLOCK) {
+                const BarrelTermEntry* entry = findEntry(barrelID, lexID);
+                const auto* table = reinterpret_cast<const BarrelTermEntry*>(file.data() + sizeof(BarrelHeader));
+                if (!entry || !blockInFile(*header, table, entry, file.size())) return PostingCursor();
+                return PostingCursor::fromBlocks(
+                    reinterpret_cast<const uint8_t*>(file.data() + entry->offset),
+                    barrelBlockSize(*header, table, entry - table, file.size()), entry->length);
+            }
+        }
+        return PostingCursor(fetch(barrelID, lexID, scratch));
+    }
+
+private:
+    // The entry's block must lie inside the file. Checked as a remainder
+    // so that a corrupt offset cannot wrap the sum.
+    static bool blockInFile(const BarrelHeader& header, const BarrelTermEntry* table,
+                            const BarrelTermEntry* entry, size_t fileSize) {
+        if (entry->offset > fileSize) return false;
+        return barrelBlockSize(header, table, entry - table, fileSize) <= fileSize - entry->offset;
+    }
+
+    const BarrelTermEntry* findEntry(int barrelID, uint32_t lexID) const {
+        const MappedFile& file = files_[barrelID];
+        const auto* header = reinterpret_cast<const BarrelHeader*>(file.data());
+        const auto* table  = reinterpret_cast<const BarrelTermEntry*>(file.data() + sizeof(BarrelHeader));
+        const auto* end    = table + header->termCount;
+
+        const auto* it = std::lower_bound(table, end, lexID,
+                                          [](const BarrelTermEntry& e, uint32_t id) { return e.lexID < id; });
+        if (it == end || it->lexID != lexID) return nullptr;
+        return it;
+    }
+
+    std::vector<MappedFile> files_;
+};
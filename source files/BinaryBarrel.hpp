@@ -0,0 +1,268 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// =================================================================
+// BINARY BARREL FORMAT (barrel_N.bin)
+// =================================================================
+//
+// Little-endian, all fields 4-byte aligned:
+//
+//   BarrelHeader                      (16 bytes)
+//   BarrelTermEntry[termCount]        sorted by lexID
+//   one posting block per term, in table order
+//
+// The header version selects the block encoding:
+//   BARREL_VERSION_RAW   uint32 docIDs[length] then uint32 freqs[length]
+//   BARREL_VERSION_VBYTE delta-gap + VByte block (see PostingCodec.hpp);
+//                        a block ends where the next term's begins
+//   BARREL_VERSION_BLOCK 128-posting bit-packed blocks with skip entries
+//                        (see BlockCodec.hpp); blocks start 4-byte aligned
+//
+// Reading one posting list is a single seek + read of its block.
+
+#include "PostingCodec.hpp"
+#include "BlockCodec.hpp"
+
+const char     BARREL_MAGIC[4]      = {'L', 'U', 'M', 'B'};
+const uint32_t BARREL_VERSION_RAW   = 1;
+const uint32_t BARREL_VERSION_VBYTE = 2;
+const uint32_t BARREL_VERSION_BLOCK = 3;
+
+struct BarrelHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t termCount;
+    uint32_t postingCount;
+};
+
+struct BarrelTermEntry {
+    uint32_t lexID;
+    uint32_t offset;   // byte offset of the term's posting block from file start
+    uint32_t length;   // number of postings
+};
+
+inline bool isKnownBarrelVersion(uint32_t version) {
+    return version == BARREL_VERSION_RAW || version == BARREL_VERSION_VBYTE ||
+           version == BARREL_VERSION_BLOCK;
+}
+
+// Byte size of the posting block of table[i] in a file of fileSize bytes.
+inline size_t barrelBlockSize(const BarrelHeader& header, const BarrelTermEntry* table,
+                              size_t i, size_t fileSize)
+{
+    if (header.version == BARREL_VERSION_RAW)
+        return static_cast<size_t>(table[i].length) * 2 * sizeof(uint32_t);
+    size_t end = (i + 1 < header.termCount) ? table[i + 1].offset : fileSize;
+    return end - table[i].offset;
+}
+
+// One term's postings in docID order, freqs[i] belongs to docIDs[i].
+struct BarrelPostings {
+    std::vector<uint32_t> docIDs;
+    std::vector<uint32_t> freqs;
+};
+
+inline std::string binaryBarrelPath(const std::string& dir, int barrelID) {
+    return dir + "/barrel_" + std::to_string(barrelID) + ".bin";
+}
+
+// -------------------- WRITE --------------------
+/**
+ * @brief Serializes lexID -> postings pairs into a barrel image.
+ * Terms are sorted by lexID and every posting list by docID first.
+ */
+inline std::vector<char> serializeBinaryBarrel(std::vector<std::pair<uint32_t, BarrelPostings>> terms,
+                                               uint32_t version = BARREL_VERSION_RAW)
+{
+    std::sort(terms.begin(), terms.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    BarrelHeader header;
+    std::memcpy(header.magic, BARREL_MAGIC, 4);
+    header.version = version;
+    header.termCount = static_cast<uint32_t>(terms.size());
+    header.postingCount = 0;
+
+    std::vector<BarrelTermEntry> table;
+    table.reserve(terms.size());
+
+    std::vector<uint8_t> blocks;
+    size_t dataStart = sizeof(BarrelHeader) + sizeof(BarrelTermEntry) * header.termCount;
+
+    for (auto& [lexID, p] : terms) {
+        // Sort docIDs and carry the frequencies along
+        std::vector<size_t> order(p.docIDs.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) { return p.docIDs[a] < p.docIDs[b]; });
+
+        BarrelPostings sorted;
+        sorted.docIDs.reserve(order.size());
+        sorted.freqs.reserve(order.size());
+        for (size_t i : order) {
+            sorted.docIDs.push_back(p.docIDs[i]);
+            sorted.freqs.push_back(p.freqs[i]);
+        }
+
+        if (version == BARREL_VERSION_BLOCK)
+            blocks.resize((blocks.size() + 3) & ~size_t(3)); // keep packed words aligned
+
+        uint32_t length = static_cast<uint32_t>(sorted.docIDs.size());
+        table.push_back({lexID, static_cast<uint32_t>(dataStart + blocks.size()), length});
+        header.postingCount += length;
+
+        if (version == BARREL_VERSION_VBYTE) {
+            encodePostings(sorted.docIDs.data(), sorted.freqs.data(), length, blocks);
+        } else if (version == BARREL_VERSION_BLOCK) {
+            encodeBlockPostings(sorted.docIDs.data(), sorted.freqs.data(), length, blocks);
+        } else {
+            const auto* d = reinterpret_cast<const uint8_t*>(sorted.docIDs.data());
+            const auto* f = reinterpret_cast<const uint8_t*>(sorted.freqs.data());
+            blocks.insert(blocks.end(), d, d + length * sizeof(uint32_t));
+            blocks.insert(blocks.end(), f, f + length * sizeof(uint32_t));
+        }
+    }
+
+    std::vector<char> image(dataStart + blocks.size());
+    std::memcpy(image.data(), &header, sizeof(header));
+    std::memcpy(image.data() + sizeof(header), table.data(), table.size() * sizeof(BarrelTermEntry));
+    if (!blocks.empty())
+        std::memcpy(image.data() + dataStart, blocks.data(), blocks.size());
+    return image;
+}
+
+/**
+ * @brief Writes a barrel file (see serializeBinaryBarrel()).
+ * @return false if the file could not be written.
+ */
+inline bool writeBinaryBarrel(const std::string& path,
+                              std::vector<std::pair<uint32_t, BarrelPostings>> terms,
+                              uint32_t version = BARREL_VERSION_RAW)
+{
+    std::vector<char> image = serializeBinaryBarrel(std::move(terms), version);
+
+    std::ofstream fout(path, std::ios::binary);
+    if (!fout) {
+        std::cerr << "ERROR: Cannot write binary barrel " << path << "\n";
+        return false;
+    }
+    fout.write(image.data(), image.size());
+    return static_cast<bool>(fout);
+}
+
+// -------------------- DECODE --------------------
+/**
+ * @brief Decodes one posting block of any version, `bytes` long, into out.
+ * @return false if `length` postings cannot fit in `bytes` or decoding
+ *         would run past the block; out is then unspecified.
+ */
+inline bool decodeBarrelBlock(uint32_t version, const char* block, size_t bytes, uint32_t length,
+                              BarrelPostings& out)
+{
+    size_t minBytes = (version == BARREL_VERSION_VBYTE) ? minPostingsBytes(length)
+                    : (version == BARREL_VERSION_BLOCK) ? minBlockListBytes(length)
+                    : static_cast<size_t>(length) * 2 * sizeof(uint32_t);
+    if (bytes < minBytes) return false;
+    out.docIDs.resize(length);
+    out.freqs.resize(length);
+
+    const auto* in = reinterpret_cast<const uint8_t*>(block);
+    bool ok = true;
+    if (version == BARREL_VERSION_VBYTE) {
+        ok = decodePostings(in, in + bytes, length, out.docIDs.data(), out.freqs.data()) != nullptr;
+    } else if (version == BARREL_VERSION_BLOCK) {
+        ok = decodeBlockPostings(in, in + bytes, length, out.docIDs.data(), out.freqs.data());
+    } else {
+        std::memcpy(out.docIDs.data(), block, length * sizeof(uint32_t));
+        std::memcpy(out.freqs.data(), block + length * sizeof(uint32_t), length * sizeof(uint32_t));
+    }
+    return ok;
+}
+
+// -------------------- READ --------------------
+/**
+ * @brief Reads one lexID's postings from a binary barrel.
+ * Reads the header, binary-searches the term table in the file (a read of
+ * one fixed-size entry per probe), then does a single seek + read for the
+ * posting block. The rest of the file is never touched.
+ * @return false if the file is missing/invalid; true with empty output if the
+ *         term is simply not stored in this barrel.
+ */
+inline bool readBinaryPostings(const std::string& path, uint32_t lexID, BarrelPostings& out)
+{
+    out.docIDs.clear();
+    out.freqs.clear();
+
+    std::ifstream fin(path, std::ios::binary | std::ios::ate);
+    if (!fin) return false;
+    size_t fileSize = static_cast<size_t>(fin.tellg());
+    fin.seekg(0);
+
+    BarrelHeader header;
+    if (!fin.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, BARREL_MAGIC, 4) != 0 ||
+        !isKnownBarrelVersion(header.version))
+    {
+        std::cerr << "ERROR: Invalid binary barrel " << path << "\n";
+        return false;
+    }
+    if (sizeof(BarrelHeader) + static_cast<size_t>(header.termCount) * sizeof(BarrelTermEntry) > fileSize) {
+        std::cerr << "ERROR: Truncated term table in " << path << "\n";
+        return false;
+    }
+
+    auto readEntry = [&](size_t i, BarrelTermEntry& e) {
+        fin.seekg(sizeof(BarrelHeader) + i * sizeof(BarrelTermEntry));
+        return static_cast<bool>(fin.read(reinterpret_cast<char*>(&e), sizeof(e)));
+    };
+
+    // First entry with lexID >= the one wanted
+    size_t lo = 0, hi = header.termCount;
+    BarrelTermEntry probe;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (!readEntry(mid, probe)) return false;
+        if (probe.lexID < lexID) lo = mid + 1;
+        else hi = mid;
+    }
+    BarrelTermEntry entry;
+    if (lo == header.termCount || !readEntry(lo, entry)) return true;
+    if (entry.lexID != lexID) return true;
+
+    // Same extent as barrelBlockSize(): raw is fixed-width, the packed
+    // formats run to the next entry's offset (or the end of the file)
+    size_t end = fileSize;
+    if (header.version == BARREL_VERSION_RAW) {
+        end = entry.offset + static_cast<size_t>(entry.length) * 2 * sizeof(uint32_t);
+    } else if (lo + 1 < header.termCount) {
+        if (!readEntry(lo + 1, probe)) return false;
+        end = probe.offset;
+    }
+    if (entry.offset > end || end > fileSize) {
+        std::cerr << "ERROR: Truncated posting block in " << path << "\n";
+        return false;
+    }
+    size_t blockSize = end - entry.offset;
+
+    std::vector<char> block(blockSize);
+    fin.seekg(entry.offset);
+    if (!fin.read(block.data(), block.size())) {
+        std::cerr << "ERROR: Truncated posting block in " << path << "\n";
+        return false;
+    }
+
+    if (!decodeBarrelBlock(header.version, block.data(), block.size(), entry.length, out)) {
+        out.docIDs.clear();
+        out.freqs.clear();
+        std::cerr << "ERROR: Corrupt posting block in " << path << "\n";
+        return false;
+    }
+    return true;
+}
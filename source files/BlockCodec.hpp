@@ -0,0 +1,258 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include "PostingCodec.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LUMI_BLOCK_SSE2 1
+#endif
+
+// =================================================================
+// BIT-PACKED BLOCK POSTING CODEC (SIMD-BP128 style)
+// =================================================================
+//
+// A posting list of n entries is split into n / 128 full blocks plus a
+// tail of n % 128 postings:
+//
+//   BlockSkipEntry[fullBlocks]     last docID of each block + byte offset
+//                                  of the block from the end of this table
+//   per full block:
+//     uint32 bits                  docBits | freqBits << 8
+//     uint32 docWords[4*docBits]   docID gaps, bit-packed
+//     uint32 freqWords[4*freqBits] frequencies, bit-packed
+//   tail                           VByte postings (PostingCodec.hpp), gaps
+//                                  continuing from the last full block
+//
+// Lists shorter than one block are therefore plain VByte. Packing is
+// "vertical": value i goes to lane i % 4, so one 128-bit register holds
+// the next word of all four lanes and a block unpacks with 32 shift/mask
+// steps of 4 values each. The scalar fallback uses the same layout.
+//
+// Everything before the tail is made of 32-bit words, so the caller only
+// needs the list to start on a 4-byte boundary.
+
+const uint32_t POSTING_BLOCK_SIZE = 128;
+
+struct BlockSkipEntry {
+    uint32_t lastDocID;
+    uint32_t offset;
+};
+
+inline uint32_t bitsNeeded(const uint32_t* values, size_t n) {
+    uint32_t all = 0;
+    for (size_t i = 0; i < n; ++i) all |= values[i];
+    uint32_t bits = 0;
+    while (all) { bits++; all >>= 1; }
+    return bits;
+}
+
+/**
+ * @brief Packs 128 values of at most `bits` bits into 4 * bits words.
+ */
+inline void packBlock128(const uint32_t* in, uint32_t bits, uint32_t* out) {
+    std::memset(out, 0, 4 * bits * sizeof(uint32_t));
+    if (bits == 0) return;
+
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        uint32_t bitPos = 0;
+        for (uint32_t row = 0; row < 32; ++row) {
+            uint32_t value = in[row * 4 + lane];
+            uint32_t word = bitPos / 32, shift = bitPos % 32;
+            out[word * 4 + lane] |= value << shift;
+            if (shift + bits > 32)
+                out[(word + 1) * 4 + lane] |= value >> (32 - shift);
+            bitPos += bits;
+        }
+    }
+}
+
+/**
+ * @brief Inverse of packBlock128(): writes 128 values to out.
+ */
+inline void unpackBlock128(const uint32_t* in, uint32_t bits, uint32_t* out) {
+    if (bits == 0) {
+        std::memset(out, 0, POSTING_BLOCK_SIZE * sizeof(uint32_t));
+        return;
+    }
+
+#ifdef LUMI_BLOCK_SSE2
+    const __m128i mask = _mm_set1_epi32(bits == 32 ? -1 : static_cast<int>((1u << bits) - 1));
+    const __m128i* words = reinterpret_cast<const __m128i*>(in);
+    __m128i current = _mm_loadu_si128(words);
+    uint32_t word = 0, shift = 0;
+
+    for (uint32_t row = 0; row < 32; ++row) {
+        __m128i value = _mm_srl_epi32(current, _mm_cvtsi32_si128(static_cast<int>(shift)));
+        if (shift + bits > 32) {
+            __m128i next = _mm_loadu_si128(words + word + 1);
+            value = _mm_or_si128(value, _mm_sll_epi32(next, _mm_cvtsi32_si128(static_cast<int>(32 - shift))));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + row * 4), _mm_and_si128(value, mask));
+
+        shift += bits;
+        if (shift >= 32) {
+            shift -= 32;
+            if (++word < bits) current = _mm_loadu_si128(words + word);
+        }
+    }
+#else
+    const uint32_t mask = (bits == 32) ? 0xFFFFFFFFu : ((1u << bits) - 1);
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        uint32_t bitPos = 0;
+        for (uint32_t row = 0; row < 32; ++row) {
+            uint32_t word = bitPos / 32, shift = bitPos % 32;
+            uint64_t value = in[word * 4 + lane] >> shift;
+            if (shift + bits > 32)
+                value |= static_cast<uint64_t>(in[(word + 1) * 4 + lane]) << (32 - shift);
+            out[row * 4 + lane] = static_cast<uint32_t>(value) & mask;
+            bitPos += bits;
+        }
+    }
+#endif
+}
+
+// -------------------- ENCODE --------------------
+/**
+ * @brief Appends a docID-sorted posting list in block format to out.
+ * out.size() must be a multiple of 4 on entry (see alignment note above).
+ */
+inline void encodeBlockPostings(const uint32_t* docIDs, const uint32_t* freqs, size_t n,
+                                std::vector<uint8_t>& out)
+{
+    size_t fullBlocks = n / POSTING_BLOCK_SIZE;
+    std::vector<BlockSkipEntry> skips(fullBlocks);
+    std::vector<uint32_t> packed;
+
+    uint32_t gaps[POSTING_BLOCK_SIZE];
+    uint32_t words[4 * 32];
+    uint32_t prev = 0;
+
+    for (size_t b = 0; b < fullBlocks; ++b) {
+        const uint32_t* d = docIDs + b * POSTING_BLOCK_SIZE;
+        const uint32_t* f = freqs + b * POSTING_BLOCK_SIZE;
+
+        for (uint32_t i = 0; i < POSTING_BLOCK_SIZE; ++i) {
+            gaps[i] = d[i] - prev;
+            prev = d[i];
+        }
+        uint32_t docBits = bitsNeeded(gaps, POSTING_BLOCK_SIZE);
+        uint32_t freqBits = bitsNeeded(f, POSTING_BLOCK_SIZE);
+
+        skips[b] = {prev, static_cast<uint32_t>(packed.size() * sizeof(uint32_t))};
+        packed.push_back(docBits | (freqBits << 8));
+
+        packBlock128(gaps, docBits, words);
+        packed.insert(packed.end(), words, words + 4 * docBits);
+        packBlock128(f, freqBits, words);
+        packed.insert(packed.end(), words, words + 4 * freqBits);
+    }
+
+    const auto* s = reinterpret_cast<const uint8_t*>(skips.data());
+    const auto* p = reinterpret_cast<const uint8_t*>(packed.data());
+    out.insert(out.end(), s, s + skips.size() * sizeof(BlockSkipEntry));
+    out.insert(out.end(), p, p + packed.size() * sizeof(uint32_t));
+
+    size_t done = fullBlocks * POSTING_BLOCK_SIZE;
+    encodePostings(docIDs + done, freqs + done, n - done, out, prev);
+}
+
+// -------------------- DECODE --------------------
+// Every decoder takes the end of the list's bytes and returns false rather
+// than read past it, so a corrupt length, skip offset or bit width is an
+// error instead of a wild read.
+
+/**
+ * @brief Fewest bytes a list of n postings can take: the skip table, one
+ * header word per full block and two bytes per VByte tail posting.
+ */
+inline size_t minBlockListBytes(size_t n) {
+    size_t fullBlocks = n / POSTING_BLOCK_SIZE;
+    return fullBlocks * (sizeof(BlockSkipEntry) + sizeof(uint32_t)) +
+           minPostingsBytes(n % POSTING_BLOCK_SIZE);
+}
+
+/**
+ * @brief Header word of full block `block` of a list in [in, end), or
+ * nullptr if the block is misaligned or its packed words would cross end.
+ * The list must be at least minBlockListBytes(n) long.
+ */
+inline const uint32_t* packedBlock(const uint8_t* in, const uint8_t* end, size_t n, size_t block)
+{
+    size_t bytes = static_cast<size_t>(end - in);
+    const auto* skips = reinterpret_cast<const BlockSkipEntry*>(in);
+    size_t start = (n / POSTING_BLOCK_SIZE) * sizeof(BlockSkipEntry) + skips[block].offset;
+    if (start % sizeof(uint32_t) != 0 || start > bytes - sizeof(uint32_t)) return nullptr;
+
+    const auto* words = reinterpret_cast<const uint32_t*>(in + start);
+    uint32_t docBits = words[0] & 0xFF, freqBits = (words[0] >> 8) & 0xFF;
+    if (docBits > 32 || freqBits > 32) return nullptr;
+    if ((1 + 4 * docBits + 4 * freqBits) * sizeof(uint32_t) > bytes - start) return nullptr;
+    return words;
+}
+
+/**
+ * @brief Decodes full block `block` of a list in [in, end).
+ * docIDs and freqs must have room for 128 values.
+ */
+inline bool decodeBlock(const uint8_t* in, const uint8_t* end, size_t n, size_t block,
+                        uint32_t* docIDs, uint32_t* freqs)
+{
+    if (static_cast<size_t>(end - in) < minBlockListBytes(n)) return false;
+    const uint32_t* words = packedBlock(in, end, n, block);
+    if (!words) return false;
+
+    uint32_t docBits = words[0] & 0xFF, freqBits = (words[0] >> 8) & 0xFF;
+    unpackBlock128(words + 1, docBits, docIDs);
+    unpackBlock128(words + 1 + 4 * docBits, freqBits, freqs);
+
+    const auto* skips = reinterpret_cast<const BlockSkipEntry*>(in);
+    uint32_t doc = (block == 0) ? 0 : skips[block - 1].lastDocID;
+    for (uint32_t i = 0; i < POSTING_BLOCK_SIZE; ++i) {
+        doc += docIDs[i];
+        docIDs[i] = doc;
+    }
+    return true;
+}
+
+/**
+ * @brief Decodes the n % 128 tail postings of a list in [in, end).
+ */
+inline bool decodeBlockTail(const uint8_t* in, const uint8_t* end, size_t n,
+                            uint32_t* docIDs, uint32_t* freqs)
+{
+    if (static_cast<size_t>(end - in) < minBlockListBytes(n)) return false;
+    size_t fullBlocks = n / POSTING_BLOCK_SIZE;
+    const auto* skips = reinterpret_cast<const BlockSkipEntry*>(in);
+    const uint8_t* tail = in + fullBlocks * sizeof(BlockSkipEntry);
+    uint32_t base = 0;
+
+    if (fullBlocks > 0) {
+        // The tail starts right after the last packed block
+        const uint32_t* last = packedBlock(in, end, n, fullBlocks - 1);
+        if (!last) return false;
+        uint32_t docBits = last[0] & 0xFF, freqBits = (last[0] >> 8) & 0xFF;
+        tail = reinterpret_cast<const uint8_t*>(last + 1 + 4 * docBits + 4 * freqBits);
+        base = skips[fullBlocks - 1].lastDocID;
+    }
+
+    size_t rest = n % POSTING_BLOCK_SIZE;
+    return rest == 0 || decodePostings(tail, end, rest, docIDs, freqs, base) != nullptr;
+}
+
+/**
+ * @brief Decodes a whole block-format list of n postings in [in, end).
+ */
+inline bool decodeBlockPostings(const uint8_t* in, const uint8_t* end, size_t n,
+                                uint32_t* docIDs, uint32_t* freqs)
+{
+    size_t fullBlocks = n / POSTING_BLOCK_SIZE;
+    for (size_t b = 0; b < fullBlocks; ++b)
+        if (!decodeBlock(in, end, n, b, docIDs + b * POSTING_BLOCK_SIZE, freqs + b * POSTING_BLOCK_SIZE))
+            return false;
+    return decodeBlockTail(in, end, n, docIDs + fullBlocks * POSTING_BLOCK_SIZE,
+                           freqs + fullBlocks * POSTING_BLOCK_SIZE);
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+#include "PostingCursor.hpp"
+
+// =================================================================
+// N-WAY CONJUNCTION (document-at-a-time AND)
+// =================================================================
+//
+// Walks the documents present in every posting list, ascending. The
+// lists are ordered by cost (document frequency), so the rarest term
+// proposes candidates and the others are only advance()d to them; when a
+// list overshoots, its docID becomes the next candidate. Work therefore
+// follows the rarest list, not the order the query words were typed in,
+// and the walk stops the moment any list is exhausted.
+//
+// The cursors stay owned by the caller and are left positioned on the
+// current match, so their freq() can be read per term. Cursor is
+// PostingCursor or anything with the same atEnd / docID / next /
+// advance interface (the boolean query iterators, QueryIterators.hpp).
+
+template <typename Cursor = PostingCursor>
+class Conjunction {
+public:
+    /**
+     * @brief lists[i] costs costs[i] (its DF); the cheapest leads.
+     * Positions on the first match, if any.
+     */
+    Conjunction(const std::vector<Cursor*>& lists, const std::vector<uint32_t>& costs)
+    {
+        for (size_t i = 0; i < lists.size(); ++i) insert(lists[i], costs[i]);
+        start();
+    }
+
+    // Over a cursor list in the query arena (QueryScratch.hpp); the
+    // conjunction's own arrays come from the same memory resource
+    Conjunction(std::pmr::vector<Cursor>& cursors, const std::pmr::vector<uint32_t>& costs)
+        : lists_(cursors.get_allocator()), costs_(cursors.get_allocator())
+    {
+        lists_.reserve(cursors.size());
+        costs_.reserve(cursors.size());
+        for (size_t i = 0; i < cursors.size(); ++i) insert(&cursors[i], costs[i]);
+        start();
+    }
+
+    bool atEnd() const { return done_; }
+    uint32_t docID() const { return lists_[0]->docID(); }
+
+    // Cost of the leading list: an upper bound on the number of matches
+    uint32_t cost() const { return costs_.empty() ? 0 : costs_[0]; }
+
+    void next() {
+        if (done_) return;
+        Cursor& lead = *lists_[0];
+        lead.next();
+        if (lead.atEnd()) { done_ = true; return; }
+        align(lead.docID());
+    }
+
+    /**
+     * @brief Moves to the first match with docID >= target.
+     * @return true if that match's docID equals target.
+     */
+    bool advance(uint32_t target) {
+        if (done_) return false;
+        if (docID() < target) align(target);
+        return !done_ && docID() == target;
+    }
+
+private:
+    // Insertion by ascending cost, after equal costs (a query has few terms)
+    void insert(Cursor* list, uint32_t cost) {
+        size_t i = lists_.size();
+        lists_.push_back(list);
+        costs_.push_back(cost);
+        for (; i > 0 && costs_[i - 1] > cost; --i) {
+            lists_[i] = lists_[i - 1];
+            costs_[i] = costs_[i - 1];
+        }
+        lists_[i] = list;
+        costs_[i] = cost;
+    }
+
+    void start() {
+        done_ = lists_.empty();
+        if (done_) return;
+        for (Cursor* c : lists_)
+            if (c->atEnd()) { done_ = true; return; }
+        align(lists_[0]->docID());
+    }
+
+    // Leapfrogs the lists until all of them sit on the same docID >= target
+    void align(uint32_t target) {
+        Cursor& lead = *lists_[0];
+        lead.advance(target);
+        if (lead.atEnd()) { done_ = true; return; }
+        target = lead.docID();
+
+        size_t i = 1;
+        while (i < lists_.size()) {
+            Cursor& c = *lists_[i];
+            c.advance(target);
+            if (c.atEnd()) { done_ = true; return; }
+            if (c.docID() == target) { ++i; continue; }
+
+            // c overshot: its docID is the next candidate, re-led by the rarest list
+            lead.advance(c.docID());
+            if (lead.atEnd()) { done_ = true; return; }
+            target = lead.docID();
+            i = 1;
+        }
+    }
+
+    std::pmr::vector<Cursor*> lists_;    // ascending cost
+    std::pmr::vector<uint32_t> costs_;   // of lists_
+    bool done_ = true;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "MappedFile.hpp"
+
+// =================================================================
+// DOCUMENT LENGTH COLUMN (doc_lengths.bin)
+// =================================================================
+//
+// Number of indexed words of every document, in a flat array indexed by
+// docID, for length normalization (BM25.hpp). Written at index time next
+// to the barrels. Layout:
+//
+//   DocLengthsHeader
+//   uint32 length[count]   0 for docIDs that hold no document
+
+const char     DOC_LENGTHS_MAGIC[4] = {'L', 'U', 'M', 'L'};
+const uint32_t DOC_LENGTHS_VERSION  = 1;
+
+struct DocLengthsHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t count;          // maxDocID + 1
+    uint32_t documents;      // docIDs with a length > 0: the collection size N
+    uint64_t totalLength;    // sum of all lengths
+};
+
+inline std::string docLengthsPath(const std::string& dir) {
+    return dir + "/doc_lengths.bin";
+}
+
+class DocLengths {
+public:
+    DocLengths() = default;
+    DocLengths(const DocLengths&) = delete;
+    DocLengths& operator=(const DocLengths&) = delete;
+    DocLengths(DocLengths&&) = default;
+    DocLengths& operator=(DocLengths&&) = default;
+
+    // -------------------- BUILD --------------------
+    /**
+     * @brief Serializes lengths[docID] into a column image.
+     */
+    static std::vector<char> build(const std::vector<uint32_t>& lengths)
+    {
+        DocLengthsHeader header{};
+        std::memcpy(header.magic, DOC_LENGTHS_MAGIC, 4);
+        header.version = DOC_LENGTHS_VERSION;
+        header.count = static_cast<uint32_t>(lengths.size());
+        for (uint32_t len : lengths) {
+            if (len > 0) header.documents++;
+            header.totalLength += len;
+        }
+
+        std::vector<char> image(sizeof(header) + lengths.size() * sizeof(uint32_t));
+        std::memcpy(image.data(), &header, sizeof(header));
+        if (!lengths.empty())
+            std::memcpy(image.data() + sizeof(header), lengths.data(), lengths.size() * sizeof(uint32_t));
+        return image;
+    }
+
+    static bool save(const std::string& path, const std::vector<char>& image) {
+        std::ofstream fout(path, std::ios::binary);
+        if (!fout) {
+            std::cerr << "ERROR: Cannot write document lengths " << path << "\n";
+            return false;
+        }
+        fout.write(image.data(), image.size());
+        return static_cast<bool>(fout);
+    }
+
+    // -------------------- OPEN --------------------
+    bool assign(std::vector<char> image) {
+        file_.close();
+        owned_ = std::move(image);
+        return attach(owned_.data(), owned_.size());
+    }
+
+    bool open(const std::string& path) {
+        owned_.clear();
+        count_ = 0;
+        if (!file_.open(path)) return false;
+        return attach(file_.data(), file_.size());
+    }
+
+    // -------------------- QUERY --------------------
+    bool empty() const { return documents_ == 0; }
+    uint32_t size() const { return count_; }
+    uint32_t documents() const { return documents_; }
+
+    uint32_t length(uint32_t docID) const { return docID < count_ ? lengths_[docID] : 0; }
+
+    float averageLength() const {
+        return documents_ ? static_cast<float>(static_cast<double>(totalLength_) / documents_) : 0.0f;
+    }
+
+private:
+    bool attach(const char* data, size_t size) {
+        count_ = 0;
+        documents_ = 0;
+        if (size < sizeof(DocLengthsHeader)) return false;
+
+        const auto* header = reinterpret_cast<const DocLengthsHeader*>(data);
+        if (std::memcmp(header->magic, DOC_LENGTHS_MAGIC, 4) != 0 || header->version != DOC_LENGTHS_VERSION) {
+            std::cerr << "ERROR: Invalid document lengths image\n";
+            return false;
+        }
+        if (sizeof(DocLengthsHeader) + static_cast<size_t>(header->count) * sizeof(uint32_t) > size) {
+            std::cerr << "ERROR: Truncated document lengths image\n";
+            return false;
+        }
+
+        count_       = header->count;
+        documents_   = header->documents;
+        totalLength_ = header->totalLength;
+        lengths_     = reinterpret_cast<const uint32_t*>(data + sizeof(DocLengthsHeader));
+        return true;
+    }
+
+    std::vector<char> owned_;
+    MappedFile file_;
+    uint32_t count_ = 0;
+    uint32_t documents_ = 0;
+    uint64_t totalLength_ = 0;
+    const uint32_t* lengths_ = nullptr;
+};
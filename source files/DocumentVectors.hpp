@@ -6,6 +6,7 @@
 #include <vector>
 #include <string>
 #include "nlohmann/json.hpp" 
+#include "JsonScanner.hpp"
 
 using json = nlohmann::json;
 using EmbeddingVector = std::vector<float>;
@@ -14,32 +15,32 @@ using DocumentVectorsMap = std::unordered_map<int, EmbeddingVector>;
 /**
  * @brief Loads pre-calculated document vectors from a JSON file.
  * The file is assumed to be structured as: {"1": [0.1, 0.2, 0.3...], "2": [...], ...}
+ * Vectors are scanned straight into the map (JsonScanner.hpp), no DOM.
  */
 DocumentVectorsMap loadDocumentVectors(const std::string& docVecFile) {
     DocumentVectorsMap docVectors;
-    std::ifstream fin(docVecFile);
-    
-    if(!fin.is_open()) {
+    JsonFile file;
+
+    if(!file.open(docVecFile)) {
         std::cerr << "ERROR: Cannot open Document Vectors file: " << docVecFile << "\n";
         return docVectors; 
     }
-    
-    json docVecJson;
-    try {
-        fin >> docVecJson;
-    } catch (const std::exception& e) {
-        std::cerr << "ERROR parsing document vectors JSON: " << e.what() << "\n";
-        return docVectors;
-    }
-    fin.close();
 
-    for (auto& [docID_str, vector_json] : docVecJson.items()) {
-        try {
-            int docID = std::stoi(docID_str);
-            docVectors[docID] = vector_json.get<EmbeddingVector>();
-        } catch (const std::exception& e) {
+    JsonCursor cur = file.cursor();
+    cur.object([&](std::string_view docID_str, JsonCursor& c) {
+        int docID;
+        if (!parseKey(docID_str, docID) || !c.isArray()) {
             std::cerr << "Warning: Failed to convert DocID or vector data: " << docID_str << "\n";
+            c.skip();
+            return;
         }
+        EmbeddingVector& vec = docVectors[docID];
+        c.array([&](JsonCursor& e) { vec.push_back(static_cast<float>(e.number())); });
+    });
+
+    if (!cur.ok()) {
+        std::cerr << "ERROR parsing document vectors JSON: " << docVecFile << "\n";
+        return {};
     }
     std::cout << "SUCCESS: Loaded " << docVectors.size() << " document vectors.\n";
     return docVectors;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+// =================================================================
+// FREQUENCY SKETCH
+// =================================================================
+//
+// Count-min sketch of how often recent keys were seen, for the
+// frequency-aware (TinyLFU) admission of ResultCache.hpp and PairCache.hpp:
+// a newcomer only displaces entries that are asked for less often. Keys
+// are hashes; a few KB track any number of them, overestimating at worst.
+
+/**
+ * @brief Approximate access counts of recent keys: 4 rows of 8-bit
+ * counters, halved every sampleSize accesses so old popularity fades.
+ */
+class FrequencySketch {
+public:
+    explicit FrequencySketch(size_t width = 4096)
+        : width_(width), counters_(ROWS * width, 0), sampleSize_(10 * width) {}
+
+    void record(size_t hash) {
+        // Conservative update: raise only the counters at the current minimum
+        uint8_t least = estimate(hash);
+        if (least < 255) {
+            for (size_t r = 0; r < ROWS; ++r) {
+                uint8_t& c = counter(r, hash);
+                if (c == least) ++c;
+            }
+        }
+        if (++accesses_ >= sampleSize_) age();
+    }
+
+    uint8_t estimate(size_t hash) const {
+        uint8_t least = 255;
+        for (size_t r = 0; r < ROWS; ++r) least = std::min(least, counters_[slot(r, hash)]);
+        return least;
+    }
+
+    void clear() {
+        std::fill(counters_.begin(), counters_.end(), 0);
+        accesses_ = 0;
+    }
+
+private:
+    static constexpr size_t ROWS = 4;
+
+    size_t slot(size_t row, size_t hash) const {
+        uint64_t h = (hash + row) * 0x9E3779B97F4A7C15ull;
+        return row * width_ + static_cast<size_t>((h ^ (h >> 29)) % width_);
+    }
+    uint8_t& counter(size_t row, size_t hash) { return counters_[slot(row, hash)]; }
+
+    void age() {
+        for (uint8_t& c : counters_) c >>= 1;
+        accesses_ = 0;
+    }
+
+    size_t width_;
+    std::vector<uint8_t> counters_;
+    size_t sampleSize_;
+    size_t accesses_ = 0;
+};
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include "BlockCodec.hpp"
+#include "MappedFile.hpp"
+#include "PostingCursor.hpp"
+#include "TermDictionary.hpp"
+
+// =================================================================
+// SINGLE-FILE INDEX SEGMENT (lumi.seg)
+// =================================================================
+//
+// Everything the engine needs in one mmap-able file, replacing
+// lexicon.json + barrel_map.json + df_map.json + barrels/*.json.
+// Little-endian, every section starts 8-byte aligned:
+//
+//   SegmentHeader
+//   dictionary   TermDictionary image (minimal perfect hash + sorted pool)
+//   TermMeta[maxLexID + 1]                             indexed by lexID
+//   postings     one block-format list per lexID (BlockCodec.hpp)
+//   SegmentFooter                                      FNV-1a of all bytes before it
+
+const char     SEGMENT_MAGIC[4] = {'L', 'U', 'M', 'S'};
+const uint32_t SEGMENT_VERSION  = 2;
+
+struct SegmentHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t termCount;
+    uint32_t maxLexID;
+    uint64_t dictOffset;
+    uint64_t dictSize;
+    uint64_t metaOffset;
+    uint64_t postingsOffset;
+    uint64_t footerOffset;
+};
+
+struct TermMeta {
+    uint64_t postingOffset;   // from the start of the postings section
+    uint32_t postingCount;
+    uint32_t df;
+    uint32_t barrel;          // original barrel, kept for tooling
+    uint32_t reserved;
+};
+
+struct SegmentFooter {
+    uint64_t checksum;
+    char     magic[4];
+    uint32_t reserved;
+};
+
+inline uint64_t fnv1a64(const char* data, size_t n, uint64_t hash = 1469598103934665603ull) {
+    for (size_t i = 0; i < n; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// -------------------- WRITE --------------------
+// One term as the builder sees it.
+struct SegmentTerm {
+    std::string word;
+    uint32_t lexID;
+};
+
+/**
+ * @brief Writes a segment file.
+ * @param terms    Lexicon entries (any order).
+ * @param meta     TermMeta per lexID (postingOffset/postingCount are filled in here).
+ * @param postings postings[lexID] = docID-sorted docIDs/freqs of that term.
+ */
+inline bool writeIndexSegment(const std::string& path,
+                              const std::vector<SegmentTerm>& terms,
+                              std::vector<TermMeta> meta,
+                              const std::vector<std::pair<std::vector<uint32_t>, std::vector<uint32_t>>>& postings)
+{
+    auto align8 = [](std::vector<char>& buf) { buf.resize((buf.size() + 7) & ~size_t(7)); };
+    auto append = [](std::vector<char>& buf, const void* p, size_t n) {
+        const char* c = static_cast<const char*>(p);
+        buf.insert(buf.end(), c, c + n);
+    };
+
+    SegmentHeader header{};
+    std::memcpy(header.magic, SEGMENT_MAGIC, 4);
+    header.version = SEGMENT_VERSION;
+    header.termCount = static_cast<uint32_t>(terms.size());
+    header.maxLexID = meta.empty() ? 0 : static_cast<uint32_t>(meta.size() - 1);
+
+    std::vector<char> out(sizeof(SegmentHeader));
+    align8(out);
+
+    // Dictionary
+    std::vector<std::pair<std::string, uint32_t>> words;
+    words.reserve(terms.size());
+    for (const auto& t : terms) words.emplace_back(t.word, t.lexID);
+    std::vector<char> dict = TermDictionary::build(std::move(words));
+
+    header.dictOffset = out.size();
+    header.dictSize = dict.size();
+    append(out, dict.data(), dict.size());
+    align8(out);
+
+    // Postings go after the meta table, so encode them first
+    std::vector<uint8_t> blocks;
+    for (size_t id = 0; id < meta.size(); ++id) {
+        blocks.resize((blocks.size() + 3) & ~size_t(3));
+        meta[id].postingOffset = blocks.size();
+        meta[id].postingCount = 0;
+        if (id < postings.size() && !postings[id].first.empty()) {
+            const auto& [docs, freqs] = postings[id];
+            meta[id].postingCount = static_cast<uint32_t>(docs.size());
+            encodeBlockPostings(docs.data(), freqs.data(), docs.size(), blocks);
+        }
+    }
+
+    header.metaOffset = out.size();
+    append(out, meta.data(), meta.size() * sizeof(TermMeta));
+    align8(out);
+
+    header.postingsOffset = out.size();
+    append(out, blocks.data(), blocks.size());
+    align8(out);
+
+    header.footerOffset = out.size();
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    SegmentFooter footer{};
+    footer.checksum = fnv1a64(out.data(), out.size());
+    std::memcpy(footer.magic, SEGMENT_MAGIC, 4);
+    append(out, &footer, sizeof(footer));
+
+    std::ofstream fout(path, std::ios::binary);
+    if (!fout) {
+        std::cerr << "ERROR: Cannot write segment " << path << "\n";
+        return false;
+    }
+    fout.write(out.data(), out.size());
+    return static_cast<bool>(fout);
+}
+
+// -------------------- READ --------------------
+/**
+ * @brief Read-only view of a mapped segment file. open() is a single
+ * mmap plus bounds checks of the sections and the TermMeta table;
+ * nothing is parsed or copied.
+ */
+class IndexSegment {
+public:
+    /**
+     * @brief Maps the segment and checks that every section and posting
+     * list lies inside the file. With verify, the footer checksum is
+     * checked too (one sequential pass over the file).
+     */
+    bool open(const std::string& path, bool verify = true) {
+        if (!file_.open(path)) return false;
+
+        const char* base = file_.data();
+        if (file_.size() < sizeof(SegmentHeader) + sizeof(SegmentFooter)) return fail(path, "too small");
+
+        header_ = reinterpret_cast<const SegmentHeader*>(base);
+        if (std::memcmp(header_->magic, SEGMENT_MAGIC, 4) != 0 || header_->version != SEGMENT_VERSION)
+            return fail(path, "bad magic or version");
+        if (header_->footerOffset + sizeof(SegmentFooter) != file_.size())
+            return fail(path, "truncated");
+
+        const auto* footer = reinterpret_cast<const SegmentFooter*>(base + header_->footerOffset);
+        if (std::memcmp(footer->magic, SEGMENT_MAGIC, 4) != 0) return fail(path, "bad footer");
+        if (verify && fnv1a64(base, header_->footerOffset) != footer->checksum)
+            return fail(path, "checksum mismatch");
+
+        // Offsets are compared as remainders so that a corrupt one cannot
+        // wrap a sum
+        if (header_->dictOffset % 8 != 0 || header_->dictOffset > header_->footerOffset ||
+            header_->dictSize > header_->footerOffset - header_->dictOffset ||
+            !dict_.attach(base + header_->dictOffset, header_->dictSize))
+            return fail(path, "bad dictionary");
+        for (uint32_t i = 0; i < dict_.size(); ++i)
+            if (dict_.lexID(i) > header_->maxLexID) return fail(path, "bad dictionary");
+
+        uint64_t metaSize = (static_cast<uint64_t>(header_->maxLexID) + 1) * sizeof(TermMeta);
+        if (header_->metaOffset % 8 != 0 || header_->postingsOffset % 8 != 0 ||
+            header_->metaOffset > header_->postingsOffset ||
+            header_->postingsOffset > header_->footerOffset ||
+            metaSize > header_->postingsOffset - header_->metaOffset)
+            return fail(path, "bad section offsets");
+
+        meta_         = reinterpret_cast<const TermMeta*>(base + header_->metaOffset);
+        postings_     = reinterpret_cast<const uint8_t*>(base + header_->postingsOffset);
+        postingsSize_ = header_->footerOffset - header_->postingsOffset;
+
+        // Lists are stored in lexID order, each 4-byte aligned and running
+        // to the start of the next
+        for (uint32_t id = 0; id <= header_->maxLexID; ++id) {
+            uint64_t offset = meta_[id].postingOffset, end = postingEnd(id);
+            if (offset % 4 != 0 || offset > end || end > postingsSize_ ||
+                minBlockListBytes(meta_[id].postingCount) > end - offset)
+                return fail(path, "bad posting list");
+        }
+        return true;
+    }
+
+    bool isOpen() const { return file_.isOpen() && header_ != nullptr; }
+    uint32_t termCount() const { return header_->termCount; }
+    uint32_t maxLexID() const { return header_->maxLexID; }
+
+    // Points into the mapping; valid while the segment is open
+    const TermDictionary& dictionary() const { return dict_; }
+
+    // i-th term in sorted order
+    std::string_view term(uint32_t i) const { return dict_.term(i); }
+
+    /**
+     * @brief lexID of word, or -1 if it is not in the lexicon.
+     */
+    int lookup(std::string_view word) const { return dict_.lookup(word); }
+
+    const TermMeta* meta(int lexID) const {
+        if (lexID < 0 || static_cast<uint32_t>(lexID) > header_->maxLexID) return nullptr;
+        return meta_ + lexID;
+    }
+
+    PostingCursor cursor(int lexID) const {
+        const TermMeta* m = meta(lexID);
+        if (!m || m->postingCount == 0) return PostingCursor();
+        return PostingCursor::fromBlocks(postings_ + m->postingOffset,
+                                         postingEnd(lexID) - m->postingOffset, m->postingCount);
+    }
+
+private:
+    // Offset just past lexID's list: the next list's start, or the end of
+    // the postings section for the last
+    uint64_t postingEnd(uint32_t lexID) const {
+        return lexID < header_->maxLexID ? meta_[lexID + 1].postingOffset : postingsSize_;
+    }
+
+    bool fail(const std::string& path, const char* why) {
+        std::cerr << "ERROR: Invalid segment " << path << " (" << why << ")\n";
+        file_.close();
+        header_ = nullptr;
+        return false;
+    }
+
+    MappedFile file_;
+    const SegmentHeader* header_ = nullptr;
+    TermDictionary dict_;
+    const TermMeta* meta_ = nullptr;
+    const uint8_t* postings_ = nullptr;
+    uint64_t postingsSize_ = 0;
+};
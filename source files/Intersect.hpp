@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include "PostingCursor.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LUMI_INTERSECT_AVX2 1
+#endif
+
+// =================================================================
+// SORTED-ARRAY POSTING INTERSECTION
+// =================================================================
+//
+// Postings are docID-sorted arrays with frequencies in a parallel array.
+// The kernels below report *positions* of the common docIDs in both
+// inputs, so callers carry any number of parallel arrays (freqs, per-word
+// TFs) along without the kernel knowing about them.
+//
+//   intersectLinear     merge walk, O(na + nb)
+//   intersectGalloping  exponential + binary search of the long list for
+//                       every element of the short one, O(na log(nb/na))
+//   intersectBlocks     AVX2: compares 8 docIDs against 8 at a time
+//   intersectPositions  picks one of the above from the size ratio
+
+// Lists this many times longer than the other are galloped, not merged
+const size_t GALLOP_RATIO = 16;
+
+// Postings owned as sorted flat arrays; freqs[i] belongs to docIDs[i].
+struct PostingArray {
+    std::vector<uint32_t> docIDs;
+    std::vector<uint32_t> freqs;
+
+    size_t size() const { return docIDs.size(); }
+    bool empty() const { return docIDs.empty(); }
+    void clear() { docIDs.clear(); freqs.clear(); }
+
+    PostingSpan span() const {
+        return {docIDs.data(), freqs.data(), static_cast<uint32_t>(docIDs.size())};
+    }
+};
+
+// -------------------- KERNELS --------------------
+// Each writes matching positions to outA / outB (room for min(na, nb))
+// and returns the number of matches.
+
+inline size_t intersectLinear(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+                              uint32_t* outA, uint32_t* outB)
+{
+    size_t i = 0, j = 0, n = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) ++i;
+        else if (a[i] > b[j]) ++j;
+        else {
+            outA[n] = static_cast<uint32_t>(i++);
+            outB[n++] = static_cast<uint32_t>(j++);
+        }
+    }
+    return n;
+}
+
+// First position in b[lo, hi) not less than target. Branch-free halving:
+// the bracket is small and the comparisons are unpredictable.
+inline size_t lowerBoundFrom(const uint32_t* b, size_t lo, size_t hi, uint32_t target)
+{
+    const uint32_t* base = b + lo;
+    size_t n = hi - lo;
+    while (n > 1) {
+        size_t half = n / 2;
+        base = (base[half] < target) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<size_t>(base - b) + (n == 1 && *base < target);
+}
+
+// a is the short list
+inline size_t intersectGalloping(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+                                 uint32_t* outA, uint32_t* outB)
+{
+    size_t j = 0, n = 0;
+    for (size_t i = 0; i < na && j < nb; ++i) {
+        uint32_t target = a[i];
+        if (b[j] < target) {
+            // Double the step until we pass target, then binary-search the bracket
+            size_t step = 1, lo = j;
+            while (lo + step < nb && b[lo + step] < target) {
+                lo += step;
+                step <<= 1;
+            }
+            j = lowerBoundFrom(b, lo + 1, std::min(lo + step + 1, nb), target);
+            if (j >= nb) break;
+        }
+        if (b[j] == target) {
+            outA[n] = static_cast<uint32_t>(i);
+            outB[n++] = static_cast<uint32_t>(j++);
+        }
+    }
+    return n;
+}
+
+#ifdef LUMI_INTERSECT_AVX2
+// Block compare: each 8-docID block of a is tested against all 8 rotations
+// of the current block of b, then whichever block ends first is advanced.
+// The tail is merged linearly.
+inline size_t intersectBlocks(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+                              uint32_t* outA, uint32_t* outB)
+{
+    // Every rotation is taken from the loaded block, so the permutes are
+    // independent instead of one serial chain
+    __m256i rot[8];
+    for (int r = 0; r < 8; ++r)
+        rot[r] = _mm256_setr_epi32(r, (r + 1) & 7, (r + 2) & 7, (r + 3) & 7,
+                                   (r + 4) & 7, (r + 5) & 7, (r + 6) & 7, (r + 7) & 7);
+    size_t i = 0, j = 0, n = 0;
+
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+
+        __m256i hits = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; ++r)
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi32(va, _mm256_permutevar8x32_epi32(vb, rot[r])));
+
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(hits));
+        if (mask) {
+            size_t k = j;
+            for (size_t lane = 0; lane < 8; ++lane) {
+                if (!(mask & (1 << lane))) continue;
+                while (b[k] != a[i + lane]) ++k; // both blocks are sorted
+                outA[n] = static_cast<uint32_t>(i + lane);
+                outB[n++] = static_cast<uint32_t>(k);
+            }
+        }
+
+        uint32_t lastA = a[i + 7], lastB = b[j + 7];
+        if (lastA <= lastB) i += 8;
+        if (lastB <= lastA) j += 8;
+    }
+
+    // Linear tail, positions offset back into the full arrays
+    size_t tail = intersectLinear(a + i, na - i, b + j, nb - j, outA + n, outB + n);
+    for (size_t t = n; t < n + tail; ++t) {
+        outA[t] += static_cast<uint32_t>(i);
+        outB[t] += static_cast<uint32_t>(j);
+    }
+    return n + tail;
+}
+#endif
+
+/**
+ * @brief Positions of the docIDs common to a and b, in ascending docID
+ * order. Gallops through the longer list when the sizes are far apart,
+ * otherwise merges (with AVX2 block compares when available).
+ */
+inline size_t intersectPositions(const PostingSpan& a, const PostingSpan& b,
+                                 std::vector<uint32_t>& outA, std::vector<uint32_t>& outB)
+{
+    size_t cap = std::min(a.size, b.size);
+    outA.resize(cap);
+    outB.resize(cap);
+    if (cap == 0) return 0;
+
+    size_t n;
+    if (a.size * GALLOP_RATIO <= b.size)
+        n = intersectGalloping(a.docIDs, a.size, b.docIDs, b.size, outA.data(), outB.data());
+    else if (b.size * GALLOP_RATIO <= a.size)
+        n = intersectGalloping(b.docIDs, b.size, a.docIDs, a.size, outB.data(), outA.data());
+    else
+#ifdef LUMI_INTERSECT_AVX2
+        n = intersectBlocks(a.docIDs, a.size, b.docIDs, b.size, outA.data(), outB.data());
+#else
+        n = intersectLinear(a.docIDs, a.size, b.docIDs, b.size, outA.data(), outB.data());
+#endif
+
+    outA.resize(n);
+    outB.resize(n);
+    return n;
+}
+
+/**
+ * @brief Common docIDs of a and b with their frequencies summed, the
+ * same result the old unordered_map intersect() produced, but sorted.
+ */
+inline void intersectSum(const PostingSpan& a, const PostingSpan& b, PostingArray& out)
+{
+    std::vector<uint32_t> posA, posB;
+    size_t n = intersectPositions(a, b, posA, posB);
+
+    out.docIDs.resize(n);
+    out.freqs.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        out.docIDs[k] = a.docIDs[posA[k]];
+        out.freqs[k] = a.freqs[posA[k]] + b.freqs[posB[k]];
+    }
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "MappedFile.hpp"
+
+// =================================================================
+// ON-DEMAND JSON SCANNER
+// =================================================================
+//
+// Forward-only cursor over JSON text that never builds a DOM: callers
+// walk objects/arrays with callbacks and pull each value straight into
+// their own structures, or skip() it. Strings without escapes come back
+// as views into the input; skipping a value only looks for quotes and
+// brackets. Built for the flat artifacts this project writes
+// (lexicon, barrel map, DF map, barrels, inverted index, doc vectors).
+//
+// Malformed input puts the cursor in a failed state and jumps to the
+// end, so every loop terminates; check ok() afterwards.
+
+class JsonCursor {
+public:
+    JsonCursor(const char* begin, const char* end) : p_(begin), end_(end) {}
+    explicit JsonCursor(std::string_view text) : JsonCursor(text.data(), text.data() + text.size()) {}
+
+    bool ok() const { return !failed_; }
+
+    // Next significant character, or 0 at the end
+    char peek() {
+        skipWhitespace();
+        return p_ < end_ ? *p_ : 0;
+    }
+
+    bool isObject() { return peek() == '{'; }
+    bool isArray()  { return peek() == '['; }
+    bool isString() { return peek() == '"'; }
+    bool isNumber() { char c = peek(); return c == '-' || (c >= '0' && c <= '9'); }
+
+    // -------------------- SCALARS --------------------
+    /**
+     * @brief Reads a string. The view points into the input, or into
+     * scratch when the string has escapes.
+     */
+    std::string_view string(std::string& scratch) {
+        if (!expect('"')) return {};
+        const char* start = p_;
+        while (p_ < end_ && *p_ != '"' && *p_ != '\\') ++p_;
+        if (p_ < end_ && *p_ == '"') return std::string_view(start, p_++ - start);
+
+        scratch.assign(start, p_);
+        while (p_ < end_ && *p_ != '"') {
+            if (*p_ != '\\') { scratch.push_back(*p_++); continue; }
+            if (++p_ >= end_) break;
+            switch (*p_++) {
+                case '"':  scratch.push_back('"');  break;
+                case '\\': scratch.push_back('\\'); break;
+                case '/':  scratch.push_back('/');  break;
+                case 'b':  scratch.push_back('\b'); break;
+                case 'f':  scratch.push_back('\f'); break;
+                case 'n':  scratch.push_back('\n'); break;
+                case 'r':  scratch.push_back('\r'); break;
+                case 't':  scratch.push_back('\t'); break;
+                case 'u':  appendCodePoint(scratch); break;
+                default:   fail(); return {};
+            }
+        }
+        if (!expect('"')) return {};
+        return scratch;
+    }
+
+    std::string string() {
+        std::string scratch;
+        return std::string(string(scratch));
+    }
+
+    // Integer value; a fractional number is truncated like json::get<int>()
+    int64_t integer() {
+        skipWhitespace();
+        int64_t value = 0;
+        auto [ptr, ec] = std::from_chars(p_, end_, value);
+        if (ec != std::errc()) { fail(); return 0; }
+        if (ptr < end_ && (*ptr == '.' || *ptr == 'e' || *ptr == 'E'))
+            return static_cast<int64_t>(numberFrom(p_));
+        p_ = ptr;
+        return value;
+    }
+
+    double number() {
+        skipWhitespace();
+        return numberFrom(p_);
+    }
+
+    bool boolean() {
+        skipWhitespace();
+        if (literal("true")) return true;
+        if (!literal("false")) fail();
+        return false;
+    }
+
+    // -------------------- CONTAINERS --------------------
+    /**
+     * @brief Walks an object; onMember(key, cursor) must consume the value
+     * (read it or skip() it). The key view is valid during the call only.
+     * If onMember returns bool, false stops the walk right after that
+     * member, leaving the cursor inside the object.
+     */
+    template <typename OnMember>
+    void object(OnMember&& onMember) {
+        if (!expect('{')) return;
+        if (peek() == '}') { ++p_; return; }
+
+        std::string keyScratch;
+        while (ok()) {
+            std::string_view key = string(keyScratch);
+            if (!expect(':')) return;
+            if constexpr (std::is_same_v<decltype(onMember(key, *this)), bool>) {
+                if (!onMember(key, *this)) return;
+            } else {
+                onMember(key, *this);
+            }
+            if (peek() == ',') { ++p_; continue; }
+            expect('}');
+            return;
+        }
+    }
+
+    // onElement(cursor) must consume one value
+    template <typename OnElement>
+    void array(OnElement&& onElement) {
+        if (!expect('[')) return;
+        if (peek() == ']') { ++p_; return; }
+
+        while (ok()) {
+            onElement(*this);
+            if (peek() == ',') { ++p_; continue; }
+            expect(']');
+            return;
+        }
+    }
+
+    // Number of members / elements of the next object or array (skips it)
+    size_t count() {
+        size_t n = 0;
+        if (isObject()) object([&](std::string_view, JsonCursor& c) { c.skip(); ++n; });
+        else if (isArray()) array([&](JsonCursor& c) { c.skip(); ++n; });
+        else fail();
+        return n;
+    }
+
+    // -------------------- SKIPPING --------------------
+    // Skips one value of any type without decoding it
+    void skip() {
+        char c = peek();
+        if (c == '{' || c == '[') {
+            int depth = 0;
+            while (p_ < end_) {
+                char ch = *p_;
+                if (ch == '"') { skipString(); continue; }
+                ++p_;
+                if (ch == '{' || ch == '[') ++depth;
+                else if ((ch == '}' || ch == ']') && --depth == 0) return;
+            }
+            fail();
+        } else if (c == '"') {
+            skipString();
+        } else if (c == 't' || c == 'f') {
+            boolean();
+        } else if (c == 'n') {
+            if (!literal("null")) fail();
+        } else if (isNumber()) {
+            while (p_ < end_ && isNumberChar(*p_)) ++p_;
+        } else {
+            fail();
+        }
+    }
+
+    // Skips one value and returns its exact text
+    std::string_view raw() {
+        skipWhitespace();
+        const char* start = p_;
+        skip();
+        return std::string_view(start, p_ - start);
+    }
+
+private:
+    static bool isNumberChar(char c) {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+    }
+
+    void skipWhitespace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+    }
+
+    bool expect(char c) {
+        if (peek() != c) { fail(); return false; }
+        ++p_;
+        return true;
+    }
+
+    bool literal(const char* word) {
+        size_t n = std::strlen(word);
+        if (static_cast<size_t>(end_ - p_) < n || std::memcmp(p_, word, n) != 0) return false;
+        p_ += n;
+        return true;
+    }
+
+    void skipString() {
+        ++p_; // opening quote
+        while (p_ < end_) {
+            const void* hit = std::memchr(p_, '"', end_ - p_);
+            if (!hit) break;
+            const char* q = static_cast<const char*>(hit);
+            // A quote preceded by an odd number of backslashes is escaped
+            const char* b = q;
+            while (b > p_ && b[-1] == '\\') --b;
+            p_ = q + 1;
+            if ((q - b) % 2 == 0) return;
+        }
+        fail();
+    }
+
+    // strtod needs a terminator; numbers are short, so copy them out
+    double numberFrom(const char* start) {
+        const char* stop = start;
+        while (stop < end_ && isNumberChar(*stop)) ++stop;
+        char buf[64];
+        size_t n = static_cast<size_t>(stop - start);
+        if (n == 0 || n >= sizeof(buf)) { fail(); return 0.0; }
+        std::memcpy(buf, start, n);
+        buf[n] = '\0';
+        char* parsedEnd = nullptr;
+        double value = std::strtod(buf, &parsedEnd);
+        if (parsedEnd != buf + n) { fail(); return 0.0; }
+        p_ = stop;
+        return value;
+    }
+
+    uint32_t hex4() {
+        if (end_ - p_ < 4) { fail(); return 0; }
+        uint32_t v = 0;
+        auto [ptr, ec] = std::from_chars(p_, p_ + 4, v, 16);
+        if (ec != std::errc() || ptr != p_ + 4) { fail(); return 0; }
+        p_ += 4;
+        return v;
+    }
+
+    void appendCodePoint(std::string& out) {
+        uint32_t cp = hex4();
+        if (cp >= 0xD800 && cp <= 0xDBFF && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+            p_ += 2;
+            uint32_t low = hex4();
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    void fail() {
+        failed_ = true;
+        p_ = end_;
+    }
+
+    const char* p_;
+    const char* end_;
+    bool failed_ = false;
+};
+
+// Decimal key such as "123" -> 123; false if the key is not an integer
+inline bool parseKey(std::string_view key, int& out) {
+    auto [ptr, ec] = std::from_chars(key.data(), key.data() + key.size(), out);
+    return ec == std::errc() && ptr == key.data() + key.size();
+}
+
+/**
+ * @brief A JSON file mapped for scanning. open() fails on a missing or
+ * empty file; cursor() starts at the beginning of the text.
+ */
+class JsonFile {
+public:
+    bool open(const std::string& path) { return file_.open(path); }
+    JsonCursor cursor() const { return JsonCursor(file_.data(), file_.data() + file_.size()); }
+    const char* data() const { return file_.data(); }
+    size_t size() const { return file_.size(); }
+
+private:
+    MappedFile file_;
+};
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Search logic (defines SearchResult, run_search and the loaders)
+#include "new_Semantic.cpp"
+#include "ResultCache.hpp"
+
+// Results of LumiEngine::searchBatch(): query i's results, best first, are
+// entries [offsets[i], offsets[i + 1]) of docIDs and scores.
+struct BatchResults {
+    std::vector<uint32_t> offsets;   // queries + 1 entries
+    std::vector<int32_t> docIDs;
+    std::vector<float> scores;
+};
+
+// Everything a search reads that addDocument() or setBM25() replaces.
+// Never modified once published: a search holds the snapshot it started
+// with, so a writer publishing the next one cannot change it midway.
+struct IndexSnapshot {
+    std::shared_ptr<const TermDictionary> lex; // Word -> lexID; also serves prefix completion
+    std::shared_ptr<const TermStats> stats;    // Barrel / DF arrays indexed by lexID
+    std::shared_ptr<BarrelCache> cache;        // Decoded barrels of these postings (JSON / unmapped path)
+    BM25 bm25;                                 // Norms and per-lexID IDFs for these terms
+    QueryParallelism parallel;                 // Threads a broad query may use (rankQuery()); serial by default
+    uint64_t generation = 0;                   // Bumped by every change to results
+};
+
+// The engine exposed to Python by bindings.cpp. Kept free of pybind11 so
+// C++ tools (startup_bench.cpp) can construct and time it directly.
+//
+// Searches may run on any number of threads at once (bindings.cpp releases
+// the GIL for them). Each one loads the current IndexSnapshot; writers
+// build the next snapshot aside and publish it with one atomic store. The
+// members below are fixed once constructed, and the caches lock internally.
+class LumiEngine {
+public:
+    std::string barrelDir;
+    BarrelStore barrels;     // Mapped barrel_N.bin files, shared via the page cache
+    IndexSegment segment;    // Single-file index (lumi.seg); replaces the term tables and barrels when open
+    PositionIndex positions; // positions.pos next to the barrels / segment; only read by phrases
+    DocLengths lengths;      // doc_lengths.bin next to the barrels / segment, for BM25
+    ResultCache<SearchResult> resultCache; // Final top-k lists of repeated queries
+
+    LumiEngine(std::string lexPath, std::string mapPath, std::string dfPath, std::string bDir)
+        : barrelDir(bDir), lexPath_(lexPath), mapPath_(mapPath), dfPath_(dfPath) {
+
+        auto first = std::make_shared<IndexSnapshot>();
+        first->lex = std::make_shared<const TermDictionary>(loadTermDictionary(lexPath)); // lexicon.json or a saved .dict
+        first->stats = std::make_shared<const TermStats>(loadTermStats(mapPath, dfPath)); // JSON maps or a saved term_stats.bin
+        first->cache = std::make_shared<BarrelCache>();
+        barrels.open(barrelDir); // Falls back to JSON barrels if none are mapped
+        positions.open(positionIndexPath(barrelDir)); // Optional: phrases degrade to AND without it
+        lengths.open(docLengthsPath(barrelDir)); // Optional: no length normalization without it
+        first->bm25 = scoring(*first->stats, BM25Params());
+        snapshot_ = std::move(first);
+    }
+
+    // Opens a single-file segment built by build_segment.cpp: one mmap, no JSON
+    explicit LumiEngine(std::string segmentPath) {
+        if (!segment.open(segmentPath))
+            throw std::runtime_error("Cannot open index segment: " + segmentPath);
+        fs::path dir = fs::path(segmentPath).parent_path();
+        positions.open(positionIndexPath(dir.empty() ? "." : dir.string()));
+        lengths.open(docLengthsPath(dir.empty() ? "." : dir.string()));
+
+        auto first = std::make_shared<IndexSnapshot>();
+        first->lex = std::make_shared<const TermDictionary>();
+        first->stats = std::make_shared<const TermStats>();
+        first->cache = std::make_shared<BarrelCache>();
+        first->bm25 = scoring(*first->stats, BM25Params());
+        snapshot_ = std::move(first);
+    }
+
+    // The index searches currently start from
+    std::shared_ptr<const IndexSnapshot> snapshot() const { return std::atomic_load(&snapshot_); }
+
+    // This calls the function in new_Semantic.cpp; returns the best k, best first.
+    // A QueryMode::Boolean query that does not parse throws std::invalid_argument.
+    // Repeated queries are answered from resultCache while the index is unchanged.
+    std::vector<SearchResult> search(std::string query, size_t k = DEFAULT_TOP_K,
+                                     QueryMode mode = QueryMode::And) {
+        std::shared_ptr<const IndexSnapshot> snap = snapshot();
+        std::string key = queryCacheKey(query, k, mode);
+        std::vector<SearchResult> ranked;
+        if (resultCache.lookup(key, snap->generation, ranked)) return ranked;
+
+        ranked = searchUncached(*snap, query, k, mode);
+        resultCache.insert(key, snap->generation, ranked);
+        return ranked;
+    }
+
+    // search() without the result cache (benchmarks)
+    std::vector<SearchResult> searchUncached(const std::string& query, size_t k = DEFAULT_TOP_K,
+                                             QueryMode mode = QueryMode::And) {
+        return searchUncached(*snapshot(), query, k, mode);
+    }
+
+    /**
+     * @brief Answers many queries at once: each query is tokenized or
+     * parsed once, each barrel holding their terms is read once (BATCH
+     * SEARCH in new_Semantic.cpp), and the queries are evaluated on
+     * `threads` threads (0: one per core), each query on one thread. Ranks
+     * as searchUncached(); the result and pair caches are neither consulted
+     * nor filled.
+     * @throws std::invalid_argument naming the first boolean query that
+     * does not parse; no query is evaluated then.
+     */
+    BatchResults searchBatch(const std::vector<std::string>& queries, size_t k = DEFAULT_TOP_K,
+                             QueryMode mode = QueryMode::And, unsigned threads = 0) {
+        std::vector<BatchQuery> prepared;
+        prepared.reserve(queries.size());
+        for (const auto& q : queries) {
+            try {
+                prepared.push_back(prepareBatchQuery(q, mode));
+            } catch (const std::invalid_argument& e) {
+                throw std::invalid_argument("query " + std::to_string(prepared.size()) +
+                                            " (\"" + q + "\"): " + e.what());
+            }
+        }
+
+        std::shared_ptr<const IndexSnapshot> snap = snapshot();
+        const TermDictionary& dict = dictionary(*snap);
+        std::vector<int> lexIDs;
+        for (const auto& q : prepared)
+            for (const auto& w : q.words)
+                if (int id = dict.lookup(w); id >= 0) lexIDs.push_back(id);
+        std::sort(lexIDs.begin(), lexIDs.end());
+        lexIDs.erase(std::unique(lexIDs.begin(), lexIDs.end()), lexIDs.end());
+
+        BatchPostings batch = segment.isOpen() ? fetchBatch(lexIDs, segment)
+                            : !barrels.empty() ? fetchBatch(lexIDs, *snap->stats, barrels, threads)
+                                               : fetchBatch(lexIDs, *snap->stats, barrelDir, *snap->cache, threads);
+
+        std::vector<std::vector<SearchResult>> ranked(prepared.size());
+        parallelFor(prepared.size(), threads, [&](size_t i) {
+            ranked[i] = run_search(prepared[i], dict, batch, snap->bm25, k, mode, &positions);
+        });
+
+        BatchResults out;
+        out.offsets.reserve(ranked.size() + 1);
+        out.offsets.push_back(0);
+        for (const auto& results : ranked) {
+            for (const SearchResult& r : results) {
+                out.docIDs.push_back(r.docID);
+                out.scores.push_back(r.score);
+            }
+            out.offsets.push_back(static_cast<uint32_t>(out.docIDs.size()));
+        }
+        return out;
+    }
+
+    // BM25 parameters: k1 >= 0 (TF saturation), 0 <= b <= 1 (length normalization)
+    void setBM25(float k1, float b) {
+        if (!(k1 >= 0.0f) || !(b >= 0.0f && b <= 1.0f))
+            throw std::invalid_argument("BM25 needs k1 >= 0 and 0 <= b <= 1");
+
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        std::shared_ptr<const IndexSnapshot> current = snapshot();
+        auto next = std::make_shared<IndexSnapshot>(*current); // same terms and barrels
+        next->bm25 = scoring(*current->stats, {k1, b});
+        next->generation = current->generation + 1; // cached scores are stale
+        std::atomic_store(&snapshot_, std::shared_ptr<const IndexSnapshot>(std::move(next)));
+    }
+
+    /**
+     * @brief Threads one query may split its docID range over (0: one per
+     * core, 1: every query serial), once its posting lists hold at least
+     * minPostings postings. Results do not depend on it.
+     *
+     * Off (1) by default: every split query starts its own threads, so
+     * under many concurrent searches the thread count multiplies. Turn it
+     * on where few searches run at once and latency matters.
+     */
+    void setQueryParallelism(unsigned threads, uint64_t minPostings) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        auto next = std::make_shared<IndexSnapshot>(*snapshot());
+        next->parallel = {threads, minPostings};
+        std::atomic_store(&snapshot_, std::shared_ptr<const IndexSnapshot>(std::move(next)));
+    }
+
+    QueryParallelism queryParallelism() const { return snapshot()->parallel; }
+
+    /**
+     * @brief Adds a document to an index served from JSON barrels: writes
+     * it with addDocument() in new_Semantic.cpp, saving the maps back to
+     * the JSON files the engine was opened with, then publishes a snapshot
+     * with term tables rebuilt from the updated maps. Results cached before
+     * are dropped. The new document is scored as average length until
+     * doc_lengths.bin is rebuilt (build_doc_lengths.cpp).
+     *
+     * Searches keep running meanwhile. One that started on the previous
+     * snapshot finishes on its tables, though a barrel it decodes after
+     * the write already holds the new document.
+     * @throws std::runtime_error for mapped barrels or a segment (rebuild
+     * them instead) or an engine built from binary term tables.
+     */
+    void addDocument(int docID, const std::string& content) {
+        if (segment.isOpen() || !barrels.empty())
+            throw std::runtime_error("addDocument needs an index served from JSON barrels");
+
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if (!editable_) loadEditableMaps();
+        std::shared_ptr<const IndexSnapshot> current = snapshot();
+
+        ::addDocument(docID, content, editLex_, editDF_, editBarrelMap_, barrelDir, lexPath_, mapPath_, dfPath_);
+        auto next = std::make_shared<IndexSnapshot>();
+        TermDictionary lex;
+        TermStats stats;
+        lex.assign(TermDictionary::build(editLex_));
+        stats.assign(TermStats::build(editBarrelMap_, editDF_, current->stats->totalDocuments() + 1));
+        next->lex = std::make_shared<const TermDictionary>(std::move(lex));
+        next->stats = std::make_shared<const TermStats>(std::move(stats));
+        next->cache = std::make_shared<BarrelCache>(current->cache->stats().budget);
+        next->bm25 = scoring(*next->stats, current->bm25.params());
+        next->parallel = current->parallel;
+        next->generation = current->generation + 1;
+        std::atomic_store(&snapshot_, std::shared_ptr<const IndexSnapshot>(std::move(next)));
+
+        // After the store, so no query of the old snapshot can add a pair
+        // once they are cleared (see searchUncached())
+        std::lock_guard<std::mutex> pairLock(pairsMutex_);
+        pairs_.clear();
+    }
+
+    // Bumped by every change to the index or to scoring
+    uint64_t generation() const { return snapshot()->generation; }
+
+    ResultCacheStats resultCacheStats() const { return resultCache.stats(); }
+    void setResultCacheBudget(size_t bytes) { resultCache.setBudget(bytes); }
+    void clearResultCache() { resultCache.clear(); }
+
+    PairCacheStats pairCacheStats() const {
+        std::lock_guard<std::mutex> lock(pairsMutex_);
+        return pairs_.stats();
+    }
+    void setPairCacheBudget(size_t bytes) {
+        std::lock_guard<std::mutex> lock(pairsMutex_);
+        pairs_.setBudget(bytes);
+    }
+    void clearPairCache() {
+        std::lock_guard<std::mutex> lock(pairsMutex_);
+        pairs_.clear();
+    }
+
+    CacheStats cacheStats() const { return snapshot()->cache->stats(); }
+    void setCacheBudget(size_t bytes) { snapshot()->cache->setBudget(bytes); }
+    void clearCache() { snapshot()->cache->clear(); }
+
+    // Alphabetical prefix matches straight from the dictionary's sorted pool
+    std::vector<std::string> complete(std::string prefix) const {
+        std::transform(prefix.begin(), prefix.end(), prefix.begin(), ::tolower);
+        std::shared_ptr<const IndexSnapshot> snap = snapshot();
+        return dictionary(*snap).complete(prefix, 5);
+    }
+
+    int lookup(const std::string& word) const {
+        std::shared_ptr<const IndexSnapshot> snap = snapshot();
+        return dictionary(*snap).lookup(word);
+    }
+    size_t lexiconSize() const {
+        std::shared_ptr<const IndexSnapshot> snap = snapshot();
+        return dictionary(*snap).size();
+    }
+
+private:
+    std::shared_ptr<const IndexSnapshot> snapshot_; // read and replaced only through std::atomic_load / atomic_store
+    std::mutex writeMutex_;                         // one writer at a time
+    PairCache pairs_;                               // Intersections of term pairs frequent in AND queries
+    mutable std::mutex pairsMutex_;                 // held by the query using pairs_
+    std::string lexPath_, mapPath_, dfPath_;        // JSON sources, for addDocument()
+    std::unordered_map<std::string, int> editLex_;  // the maps below are guarded by writeMutex_
+    DFMap editDF_;
+    std::unordered_map<int, int> editBarrelMap_;
+    bool editable_ = false;
+
+    const TermDictionary& dictionary(const IndexSnapshot& snap) const {
+        return segment.isOpen() ? segment.dictionary() : *snap.lex;
+    }
+
+    /**
+     * @brief One search on the given snapshot. The pair cache serves one
+     * AND query at a time: a query finding it busy, or running on a
+     * snapshot already replaced, goes without it (same results, no
+     * shortcut).
+     */
+    std::vector<SearchResult> searchUncached(const IndexSnapshot& snap, const std::string& query,
+                                             size_t k, QueryMode mode) {
+        std::unique_lock<std::mutex> pairLock(pairsMutex_, std::defer_lock);
+        PairCache* pairs = nullptr;
+        if (mode == QueryMode::And && pairLock.try_lock()) {
+            if (snapshot().get() == &snap) pairs = &pairs_;
+            else pairLock.unlock();
+        }
+
+        if (segment.isOpen())
+            return run_search(query, segment, snap.bm25, k, mode, &positions, pairs, snap.parallel);
+        if (!barrels.empty())
+            return run_search(query, *snap.lex, *snap.stats, barrels, snap.bm25, k, mode, &positions, pairs,
+                              snap.parallel);
+        return run_search(query, *snap.lex, *snap.stats, barrelDir, *snap.cache, snap.bm25, k, mode,
+                          &positions, pairs, snap.parallel);
+    }
+
+    static bool hasMagic(const std::string& path, const char magic[4]) {
+        char head[4] = {};
+        std::ifstream fin(path, std::ios::binary);
+        fin.read(head, 4);
+        return fin && std::memcmp(head, magic, 4) == 0;
+    }
+
+    // The mutable maps addDocument() extends, read once from the JSON files
+    void loadEditableMaps() {
+        if (lexPath_.empty() || hasMagic(lexPath_, DICT_MAGIC) || hasMagic(mapPath_, TERM_STATS_MAGIC))
+            throw std::runtime_error("addDocument needs the JSON lexicon, barrel map and DF map");
+        editLex_ = loadLexicon(lexPath_);
+        editBarrelMap_ = loadBarrelMap(mapPath_);
+        editDF_ = loadDFMap(dfPath_);
+        editable_ = true;
+    }
+
+    // BM25 prepared for this index: N from the length column, else the N
+    // the term stats were built with; IDFs from the DFs of every lexID
+    BM25 scoring(const TermStats& stats, BM25Params params) const {
+        BM25 model;
+        uint32_t fallback = (!segment.isOpen() && stats.totalDocuments()) ? stats.totalDocuments()
+                                                                          : TOTAL_DOCUMENTS;
+        model.configure(&lengths, fallback, params);
+
+        std::vector<uint32_t> dfs;
+        if (segment.isOpen()) {
+            for (uint32_t id = 0; id <= segment.maxLexID(); ++id) dfs.push_back(segment.meta(id)->df);
+        } else {
+            for (uint32_t id = 0; id < stats.size(); ++id) dfs.push_back(stats.df(id));
+        }
+        model.precomputeIDF(dfs);
+        return model;
+    }
+};
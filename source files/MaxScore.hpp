@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+#include "Wand.hpp"
+
+// =================================================================
+// RANKED OR: MAXSCORE
+// =================================================================
+//
+// Second dynamic-pruning evaluator next to WAND (Wand.hpp), same inputs
+// and same results. Terms are ordered by their score bound; the longest
+// prefix whose bounds sum to no more than the heap threshold is
+// "non-essential": a document matching only those terms cannot enter the
+// top k. So candidates come only from the essential lists, and the
+// non-essential ones are advance()d to a candidate, highest bound first,
+// only while the candidate can still reach the threshold. As the
+// threshold rises, more terms become non-essential.
+
+// True if a score bounded by `bound` may still beat `threshold`
+inline bool mayBeat(float bound, float threshold) {
+    return bound + std::fabs(bound) * 1e-4f > threshold;
+}
+
+/**
+ * @brief Best k documents containing any term, by MaxScore.
+ * cursors[i] is scored with scorers[i]; cursors are consumed. Only docIDs
+ * below endDoc are ranked (one range of a partitioned query).
+ */
+template <typename Result>
+std::vector<Result> maxScoreSearch(std::pmr::vector<PostingCursor>& cursors,
+                                   const std::pmr::vector<TermScorer>& scorers,
+                                   size_t k,
+                                   uint32_t endDoc = std::numeric_limits<uint32_t>::max())
+{
+    std::pmr::memory_resource* mem = cursors.get_allocator().resource();
+    TopK<Result> top(k, mem);
+    std::pmr::vector<ScoredCursor> terms = scoredCursors(cursors, scorers);
+    if (k == 0 || terms.empty()) return top.take();
+
+    // Ascending bound; prefix[i] = sum of the bounds of terms 0..i
+    std::pmr::vector<ScoredCursor*> byBound(mem);
+    for (auto& t : terms) byBound.push_back(&t);
+    std::sort(byBound.begin(), byBound.end(),
+              [](const ScoredCursor* a, const ScoredCursor* b) { return a->maxScore < b->maxScore; });
+    std::pmr::vector<float> prefix(byBound.size(), mem);
+    float sum = 0.0f;
+    for (size_t i = 0; i < byBound.size(); ++i) prefix[i] = (sum += byBound[i]->maxScore);
+
+    const uint32_t NO_DOC = std::numeric_limits<uint32_t>::max();
+    size_t firstEssential = 0;
+
+    for (;;) {
+        float threshold = top.full() ? static_cast<float>(top.threshold())
+                                     : -std::numeric_limits<float>::infinity();
+        while (firstEssential < byBound.size() && !mayBeat(prefix[firstEssential], threshold))
+            ++firstEssential;
+        if (firstEssential == byBound.size()) break; // no doc can enter any more
+
+        // Next candidate: the smallest docID among the essential lists
+        uint32_t doc = NO_DOC;
+        for (size_t i = firstEssential; i < byBound.size(); ++i)
+            doc = std::min(doc, docOrEnd(*byBound[i]));
+        if (doc == NO_DOC || doc >= endDoc) break;
+
+        float partial = 0.0f;
+        for (size_t i = firstEssential; i < byBound.size(); ++i) {
+            PostingCursor& c = *byBound[i]->cursor;
+            if (!c.atEnd() && c.docID() == doc) partial += byBound[i]->scorer.score(c.freq(), doc);
+        }
+
+        // Non-essential terms, highest bound first, while the doc can still make it
+        bool viable = true;
+        for (size_t i = firstEssential; i-- > 0;) {
+            if (!mayBeat(partial + prefix[i], threshold)) { viable = false; break; }
+            PostingCursor& c = *byBound[i]->cursor;
+            if (c.advance(doc)) partial += byBound[i]->scorer.score(c.freq(), doc);
+        }
+
+        // The final score is summed in term order, as scoreExhaustive() does
+        if (viable) top.push({static_cast<int>(doc), scoreAt(terms, doc)});
+
+        for (size_t i = firstEssential; i < byBound.size(); ++i) {
+            PostingCursor& c = *byBound[i]->cursor;
+            if (!c.atEnd() && c.docID() == doc) c.next();
+        }
+    }
+    return top.take();
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include "PostingCursor.hpp"
+#include "Conjunction.hpp"
+#include "FrequencySketch.hpp"
+
+// =================================================================
+// TERM-PAIR INTERSECTION CACHE
+// =================================================================
+//
+// Multi-word queries often share a sub-conjunction ("covid vaccine trial",
+// "covid vaccine efficacy"). Every AND query records the pairs of terms it
+// holds in a FrequencySketch; once a pair has been asked for hotThreshold
+// times, its intersection is materialized (the docIDs holding both terms
+// and each term's TF there) and kept, under a byte budget with LRU
+// eviction and the same frequency-aware admission as ResultCache.hpp.
+//
+// A query holding a cached pair then walks two cursors over the pair's
+// docIDs (one per term, each with its own TFs) instead of the two full
+// posting lists. Their cost is the pair size, so the Conjunction planner
+// leads with them and the query's other terms are only probed at docs
+// that already hold both.
+//
+// Entries are copies, handed out as shared_ptr like BarrelCache's, so an
+// entry evicted mid-query stays valid. The engine clears the cache when
+// the postings change.
+
+struct PairIntersection {
+    uint32_t first, second;            // lexIDs, first < second
+    std::vector<uint32_t> docIDs;      // docs holding both, ascending
+    std::vector<uint32_t> firstFreqs;  // TF of first in docIDs[i]
+    std::vector<uint32_t> secondFreqs;
+
+    PostingSpan span(uint32_t lexID) const {
+        PostingSpan s;
+        s.docIDs = docIDs.data();
+        s.freqs  = (lexID == first ? firstFreqs : secondFreqs).data();
+        s.size   = static_cast<uint32_t>(docIDs.size());
+        return s;
+    }
+
+    size_t bytes() const {
+        return sizeof(PairIntersection) +
+               (docIDs.capacity() + firstFreqs.capacity() + secondFreqs.capacity()) * sizeof(uint32_t);
+    }
+};
+
+/**
+ * @brief Intersects the lists of lexIDs a and b (copies of their cursors,
+ * which are walked to the end).
+ */
+inline PairIntersection materializePair(uint32_t a, PostingCursor cursorA, uint32_t b, PostingCursor cursorB)
+{
+    if (b < a) {
+        std::swap(a, b);
+        std::swap(cursorA, cursorB);
+    }
+    PairIntersection pair;
+    pair.first = a;
+    pair.second = b;
+
+    std::vector<PostingCursor*> lists = {&cursorA, &cursorB};
+    for (Conjunction<> match(lists, {cursorA.size(), cursorB.size()}); !match.atEnd(); match.next()) {
+        pair.docIDs.push_back(match.docID());
+        pair.firstFreqs.push_back(cursorA.freq());
+        pair.secondFreqs.push_back(cursorB.freq());
+    }
+    pair.docIDs.shrink_to_fit();
+    pair.firstFreqs.shrink_to_fit();
+    pair.secondFreqs.shrink_to_fit();
+    return pair;
+}
+
+struct PairCacheStats {
+    uint64_t hits = 0;          // AND queries that started from a cached pair
+    uint64_t misses = 0;        // AND queries with pairs, none cached
+    uint64_t materialized = 0;  // hot pairs intersected and admitted
+    uint64_t rejections = 0;    // hot pairs refused by frequency admission
+    uint64_t evictions = 0;
+    size_t bytes = 0;
+    size_t budget = 0;
+    size_t entries = 0;
+};
+
+class PairCache {
+public:
+    explicit PairCache(size_t budgetBytes = 16u << 20, uint8_t hotThreshold = 3)
+        : hotThreshold_(hotThreshold) { stats_.budget = budgetBytes; }
+
+    static uint64_t key(uint32_t a, uint32_t b) {
+        if (b < a) std::swap(a, b);
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    // Counts one query holding the pair
+    void record(uint64_t pairKey) { sketch_.record(static_cast<size_t>(pairKey)); }
+
+    uint8_t frequency(uint64_t pairKey) const { return sketch_.estimate(static_cast<size_t>(pairKey)); }
+
+    // True once the pair has been asked for often enough to materialize
+    bool hot(uint64_t pairKey) const { return frequency(pairKey) >= hotThreshold_; }
+
+    /**
+     * @brief True if a pair of up to `bytes` could be admitted now; checked
+     * before intersecting, so a pair that would be refused costs nothing.
+     * A refusal counts as a rejection.
+     */
+    bool mayAdmit(uint64_t pairKey, size_t bytes) {
+        size_t victims;
+        bool ok = entryBytes(bytes) <= stats_.budget && roomFor(entryBytes(bytes), frequency(pairKey), victims);
+        if (!ok) stats_.rejections++;
+        return ok;
+    }
+
+    std::shared_ptr<const PairIntersection> find(uint64_t pairKey) {
+        auto it = index_.find(pairKey);
+        if (it == index_.end()) return nullptr;
+        lru_.splice(lru_.begin(), lru_, it->second); // mark most recently used
+        return it->second->pair;
+    }
+
+    /**
+     * @brief Offers a materialized pair; returns it as cached, or null if
+     * it is too large or every entry that would make room is hotter.
+     */
+    std::shared_ptr<const PairIntersection> insert(PairIntersection pair) {
+        uint64_t pairKey = key(pair.first, pair.second);
+        size_t size = entryBytes(pair.bytes());
+        size_t victims;
+        if (size > stats_.budget || !roomFor(size, frequency(pairKey), victims)) {
+            stats_.rejections++;
+            return nullptr;
+        }
+        while (victims-- > 0) evict();
+
+        auto shared = std::make_shared<const PairIntersection>(std::move(pair));
+        lru_.push_front({pairKey, shared, size});
+        index_[pairKey] = lru_.begin();
+        stats_.bytes += size;
+        stats_.materialized++;
+        return shared;
+    }
+
+    void countQuery(bool hit) { (hit ? stats_.hits : stats_.misses)++; }
+
+    void setBudget(size_t budgetBytes) {
+        stats_.budget = budgetBytes;
+        while (stats_.bytes > stats_.budget && !lru_.empty()) evict();
+    }
+
+    // Drops every intersection (the postings changed); the pair
+    // frequencies are kept
+    void clear() {
+        lru_.clear();
+        index_.clear();
+        stats_.bytes = 0;
+    }
+
+    PairCacheStats stats() const {
+        PairCacheStats s = stats_;
+        s.entries = index_.size();
+        return s;
+    }
+
+private:
+    struct Entry {
+        uint64_t key;
+        std::shared_ptr<const PairIntersection> pair;
+        size_t bytes;
+    };
+
+    static size_t entryBytes(size_t pairBytes) { return pairBytes + 64; } // list and map nodes
+
+    // Whether evicting `victims` entries from the LRU end frees `bytes`
+    // without evicting one at least as frequent as the newcomer
+    bool roomFor(size_t bytes, uint8_t frequency, size_t& victims) const {
+        size_t freed = stats_.budget - stats_.bytes;
+        victims = 0;
+        for (auto it = lru_.rbegin(); freed < bytes && it != lru_.rend(); ++it, ++victims) {
+            if (this->frequency(it->key) >= frequency) return false;
+            freed += it->bytes;
+        }
+        return freed >= bytes;
+    }
+
+    void evict() {
+        const Entry& victim = lru_.back();
+        stats_.bytes -= victim.bytes;
+        index_.erase(victim.key);
+        lru_.pop_back();
+        stats_.evictions++;
+    }
+
+    uint8_t hotThreshold_;
+    std::list<Entry> lru_;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+    FrequencySketch sketch_;
+    PairCacheStats stats_;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// =================================================================
+// PARALLEL LOOPS
+// =================================================================
+//
+// Runs body(i) for i in [0, count) on up to `threads` threads (0: one
+// per core), the calling thread included. Items are handed out one at a
+// time from a shared counter, so uneven items (a short and a long query)
+// balance themselves. Each thread keeps its own QueryScratch
+// (QueryScratch.hpp), so bodies that search allocate nothing shared.
+// The first exception a body throws is rethrown once all threads stop.
+
+inline unsigned hardwareThreads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+template <typename Body>
+void parallelFor(size_t count, unsigned threads, Body&& body)
+{
+    if (threads == 0) threads = hardwareThreads();
+    threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto work = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < count;) {
+            try {
+                body(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+                next = count; // stop handing out items
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(work);
+    work();
+    for (auto& t : pool) t.join();
+
+    if (error) std::rethrow_exception(error);
+}
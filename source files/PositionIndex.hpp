@@ -0,0 +1,284 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "MappedFile.hpp"
+#include "PostingCodec.hpp"
+
+// =================================================================
+// POSITIONAL INDEX (positions.pos)
+// =================================================================
+//
+// Where in each document every term occurs (word offsets, from 0), kept
+// in its own file next to the barrels so that queries without phrases
+// never map or read it. Little-endian:
+//
+//   PositionHeader
+//   PositionTermEntry[termCount]     sorted by lexID
+//   one position list per term, 4-byte aligned
+//
+// A position list of n postings is a skip table of ceil(n / 128)
+// PositionSkip entries followed by n records, one per docID ascending:
+//
+//   VByte docID gap   (from the previous record; the first record of a
+//                      group from the previous group's lastDocID)
+//   VByte byte length of the rest of the record
+//   VByte position gaps
+//
+// The length lets a cursor step over records it does not need, and the
+// skip table lets it jump whole groups, so checking a phrase on a few
+// candidates reads only the records of those candidates.
+
+const char     POSITIONS_MAGIC[4] = {'L', 'U', 'M', 'P'};
+const uint32_t POSITIONS_VERSION  = 1;
+const uint32_t POSITION_GROUP     = 128;   // records per skip entry
+
+struct PositionHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t termCount;
+    uint32_t postingCount;
+};
+
+struct PositionTermEntry {
+    uint32_t lexID;
+    uint32_t postingCount;
+    uint64_t offset;   // byte offset of the term's position list from file start
+};
+
+struct PositionSkip {
+    uint32_t lastDocID;   // last docID of the group
+    uint32_t offset;      // of the group's first record, from the end of the skip table
+};
+
+// One term's positions: positions[i] lists, ascending, where the term
+// occurs in docIDs[i].
+struct TermPositions {
+    std::vector<uint32_t> docIDs;
+    std::vector<std::vector<uint32_t>> positions;
+};
+
+inline std::string positionIndexPath(const std::string& dir) {
+    return dir + "/positions.pos";
+}
+
+// -------------------- WRITE --------------------
+/**
+ * @brief Appends the position list of t (sorted by docID) to out.
+ */
+inline void encodePositionList(const TermPositions& t, std::vector<uint8_t>& out)
+{
+    size_t n = t.docIDs.size();
+    std::vector<PositionSkip> skips((n + POSITION_GROUP - 1) / POSITION_GROUP);
+    std::vector<uint8_t> records, payload;
+
+    uint32_t prevDoc = 0;
+    uint32_t groupStart = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (i % POSITION_GROUP == 0) groupStart = static_cast<uint32_t>(records.size());
+
+        payload.clear();
+        uint32_t prevPos = 0;
+        for (uint32_t pos : t.positions[i]) {
+            encodeVByte(pos - prevPos, payload);
+            prevPos = pos;
+        }
+
+        encodeVByte(t.docIDs[i] - prevDoc, records);
+        encodeVByte(static_cast<uint32_t>(payload.size()), records);
+        records.insert(records.end(), payload.begin(), payload.end());
+        prevDoc = t.docIDs[i];
+
+        if ((i + 1) % POSITION_GROUP == 0 || i + 1 == n)
+            skips[i / POSITION_GROUP] = {t.docIDs[i], groupStart};
+    }
+
+    const auto* s = reinterpret_cast<const uint8_t*>(skips.data());
+    out.insert(out.end(), s, s + skips.size() * sizeof(PositionSkip));
+    out.insert(out.end(), records.begin(), records.end());
+}
+
+/**
+ * @brief Writes a positional index file (see layout above). Terms are
+ * sorted by lexID and every term's postings by docID first.
+ * @return false if the file could not be written.
+ */
+inline bool writePositionIndex(const std::string& path,
+                               std::vector<std::pair<uint32_t, TermPositions>> terms)
+{
+    std::sort(terms.begin(), terms.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    PositionHeader header;
+    std::memcpy(header.magic, POSITIONS_MAGIC, 4);
+    header.version = POSITIONS_VERSION;
+    header.termCount = static_cast<uint32_t>(terms.size());
+    header.postingCount = 0;
+
+    std::vector<PositionTermEntry> table;
+    table.reserve(terms.size());
+    std::vector<uint8_t> lists;
+    size_t dataStart = sizeof(PositionHeader) + sizeof(PositionTermEntry) * header.termCount;
+
+    for (auto& [lexID, t] : terms) {
+        // Sort docIDs and carry the positions along
+        std::vector<size_t> order(t.docIDs.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) { return t.docIDs[a] < t.docIDs[b]; });
+
+        TermPositions sorted;
+        sorted.docIDs.reserve(order.size());
+        sorted.positions.reserve(order.size());
+        for (size_t i : order) {
+            sorted.docIDs.push_back(t.docIDs[i]);
+            sorted.positions.push_back(std::move(t.positions[i]));
+        }
+
+        lists.resize((lists.size() + 3) & ~size_t(3)); // keep skip tables aligned
+        uint32_t count = static_cast<uint32_t>(sorted.docIDs.size());
+        table.push_back({lexID, count, static_cast<uint64_t>(dataStart + lists.size())});
+        header.postingCount += count;
+        encodePositionList(sorted, lists);
+    }
+
+    std::ofstream fout(path, std::ios::binary);
+    if (!fout) {
+        std::cerr << "ERROR: Cannot write positional index " << path << "\n";
+        return false;
+    }
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fout.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(PositionTermEntry));
+    fout.write(reinterpret_cast<const char*>(lists.data()), lists.size());
+    return static_cast<bool>(fout);
+}
+
+// -------------------- READ --------------------
+/**
+ * @brief Forward-only reader of one term's position list. Queried with
+ * ascending docIDs (the candidates of a phrase), it jumps groups through
+ * the skip table and steps over the records in between by their length.
+ */
+class PositionCursor {
+public:
+    PositionCursor() = default;
+
+    PositionCursor(const uint8_t* data, uint32_t count)
+        : skips_(reinterpret_cast<const PositionSkip*>(data)),
+          records_(data + ((count + POSITION_GROUP - 1) / POSITION_GROUP) * sizeof(PositionSkip)),
+          count_(count), groups_((count + POSITION_GROUP - 1) / POSITION_GROUP)
+    {
+        if (groups_ > 0) enterGroup(0);
+    }
+
+    // False for a term the positional index does not cover (as opposed to
+    // one that is covered but absent from a given document)
+    bool available() const { return skips_ != nullptr; }
+
+    /**
+     * @brief Positions of the term in doc, ascending, into out.
+     * @return false if the term does not occur in doc.
+     */
+    bool positions(uint32_t doc, std::vector<uint32_t>& out) {
+        out.clear();
+        if (group_ >= groups_) return false;
+
+        if (doc > skips_[group_].lastDocID) {
+            const PositionSkip* end = skips_ + groups_;
+            const PositionSkip* it = std::lower_bound(skips_ + group_ + 1, end, doc,
+                [](const PositionSkip& s, uint32_t d) { return s.lastDocID < d; });
+            if (it == end) { group_ = groups_; return false; }
+            enterGroup(static_cast<uint32_t>(it - skips_));
+        }
+
+        while (left_ > 0) {
+            const uint8_t* record = p_;
+            uint32_t recordDoc = doc_ + decodeVByte(p_);
+            uint32_t bytes = decodeVByte(p_);
+            if (recordDoc > doc) { p_ = record; return false; } // re-read on a later call
+
+            doc_ = recordDoc;
+            --left_;
+            const uint8_t* end = p_ + bytes;
+            if (recordDoc == doc) {
+                uint32_t pos = 0;
+                while (p_ < end) out.push_back(pos += decodeVByte(p_));
+                return true;
+            }
+            p_ = end;
+        }
+        return false;
+    }
+
+private:
+    void enterGroup(uint32_t g) {
+        group_ = g;
+        p_ = records_ + skips_[g].offset;
+        doc_ = g ? skips_[g - 1].lastDocID : 0;
+        left_ = std::min(POSITION_GROUP, count_ - g * POSITION_GROUP);
+    }
+
+    const PositionSkip* skips_ = nullptr;
+    const uint8_t* records_ = nullptr;
+    uint32_t count_ = 0;
+    uint32_t groups_ = 0;
+
+    uint32_t group_ = 0;      // current group
+    const uint8_t* p_ = nullptr;
+    uint32_t doc_ = 0;        // docID of the last record consumed
+    uint32_t left_ = 0;       // records of the group not consumed yet
+};
+
+/**
+ * @brief Maps positions.pos once and hands out PositionCursors.
+ * Opening is optional: without it phrase queries cannot check adjacency.
+ */
+class PositionIndex {
+public:
+    /**
+     * @brief Maps the file. Returns false if it is missing or invalid.
+     */
+    bool open(const std::string& path) {
+        MappedFile file;
+        if (!file.open(path)) return false;
+
+        const auto* header = reinterpret_cast<const PositionHeader*>(file.data());
+        if (file.size() < sizeof(PositionHeader) ||
+            std::memcmp(header->magic, POSITIONS_MAGIC, 4) != 0 ||
+            header->version != POSITIONS_VERSION ||
+            file.size() < sizeof(PositionHeader) + header->termCount * sizeof(PositionTermEntry))
+        {
+            std::cerr << "Warning: Ignoring invalid positional index " << path << "\n";
+            return false;
+        }
+        file_ = std::move(file);
+        return true;
+    }
+
+    bool isOpen() const { return file_.isOpen(); }
+
+    /**
+     * @brief Cursor over lexID's positions; not available() if the file is
+     * not open or does not hold the term.
+     */
+    PositionCursor cursor(uint32_t lexID) const {
+        if (!file_.isOpen()) return {};
+
+        const auto* header = reinterpret_cast<const PositionHeader*>(file_.data());
+        const auto* table  = reinterpret_cast<const PositionTermEntry*>(file_.data() + sizeof(PositionHeader));
+        const auto* end    = table + header->termCount;
+
+        const auto* it = std::lower_bound(table, end, lexID,
+                                          [](const PositionTermEntry& e, uint32_t id) { return e.lexID < id; });
+        if (it == end || it->lexID != lexID || it->offset >= file_.size()) return {};
+        return PositionCursor(reinterpret_cast<const uint8_t*>(file_.data() + it->offset), it->postingCount);
+    }
+
+private:
+    MappedFile file_;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// =================================================================
+// VARIABLE-BYTE POSTING CODEC
+// =================================================================
+//
+// A posting list of n entries is stored as
+//   n VByte docID gaps  (first docID, then docID[i] - docID[i-1])
+//   n VByte frequencies
+// Each value uses 7 bits per byte, low bits first; the high bit marks
+// that another byte follows. Sorted docIDs give small gaps, so most
+// postings take 1-2 bytes instead of the 8 of the raw format.
+
+inline void encodeVByte(uint32_t value, std::vector<uint8_t>& out) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+inline uint32_t decodeVByte(const uint8_t*& in) {
+    uint32_t b = *in++;
+    if (b < 0x80) return b;                     // fast path: one byte
+    uint32_t value = b & 0x7F;
+    b = *in++; value |= (b & 0x7F) << 7;  if (b < 0x80) return value;
+    b = *in++; value |= (b & 0x7F) << 14; if (b < 0x80) return value;
+    b = *in++; value |= (b & 0x7F) << 21; if (b < 0x80) return value;
+    b = *in++; value |= b << 28;
+    return value;
+}
+
+/**
+ * @brief decodeVByte() that reads no byte at or past end.
+ * @return false, with in unchanged, if the value would cross end.
+ */
+inline bool decodeVByte(const uint8_t*& in, const uint8_t* end, uint32_t& value) {
+    uint32_t v = 0, shift = 0;
+    for (const uint8_t* p = in; p < end; shift += 7) {
+        uint32_t b = *p++;
+        if (b < 0x80 || shift == 28) {
+            value = v | (b << shift);
+            in = p;
+            return true;
+        }
+        v |= (b & 0x7F) << shift;
+    }
+    return false;
+}
+
+// Every posting takes at least two bytes, one for its gap and one for its
+// frequency, so a list of n postings needs at least this many.
+inline size_t minPostingsBytes(size_t n) {
+    return 2 * n;
+}
+
+/**
+ * @brief Appends a docID-sorted posting list to out (see layout above).
+ * The first gap is taken relative to base (0 for a whole list).
+ */
+inline void encodePostings(const uint32_t* docIDs, const uint32_t* freqs, size_t n,
+                           std::vector<uint8_t>& out, uint32_t base = 0)
+{
+    uint32_t prev = base;
+    for (size_t i = 0; i < n; ++i) {
+        encodeVByte(docIDs[i] - prev, out);
+        prev = docIDs[i];
+    }
+    for (size_t i = 0; i < n; ++i)
+        encodeVByte(freqs[i], out);
+}
+
+/**
+ * @brief Decodes n postings written by encodePostings() from [in, end).
+ * docIDs and freqs must have room for n values.
+ * @return Pointer just past the consumed bytes, or nullptr if n postings
+ *         do not fit before end or a value would cross it.
+ */
+inline const uint8_t* decodePostings(const uint8_t* in, const uint8_t* end, size_t n,
+                                     uint32_t* docIDs, uint32_t* freqs, uint32_t base = 0)
+{
+    if (static_cast<size_t>(end - in) < minPostingsBytes(n)) return nullptr;
+
+    uint32_t doc = base, value;
+    for (size_t i = 0; i < n; ++i) {
+        if (!decodeVByte(in, end, value)) return nullptr;
+        doc += value;
+        docIDs[i] = doc;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (!decodeVByte(in, end, value)) return nullptr;
+        freqs[i] = value;
+    }
+    return in;
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include "BlockCodec.hpp"
+
+// Read-only view of one term's postings.
+// docIDs is sorted ascending, freqs[i] belongs to docIDs[i].
+struct PostingSpan {
+    const uint32_t* docIDs = nullptr;
+    const uint32_t* freqs  = nullptr;
+    uint32_t size = 0;
+    uint32_t maxFreq = 0;   // largest freq if known, 0 = not recorded
+
+    bool empty() const { return size == 0; }
+};
+
+/**
+ * @brief Forward iterator over one posting list.
+ * Works either over a decoded span or directly over a block-format list
+ * (BlockCodec.hpp). In block mode only the block under the cursor is
+ * decoded; advance() consults the skip entries and jumps over whole
+ * blocks whose last docID is below the target without decoding them.
+ */
+class PostingCursor {
+public:
+    PostingCursor() = default;
+
+    explicit PostingCursor(const PostingSpan& span)
+        : docs_(span.docIDs), freqs_(span.freqs), windowSize_(span.size), size_(span.size),
+          maxFreq_(span.maxFreq) {}
+
+    // Block mode points into its own buffers, so copies must re-point
+    PostingCursor(const PostingCursor& other) { *this = other; }
+    PostingCursor& operator=(const PostingCursor& other) {
+        if (this == &other) return *this;
+        docs_ = other.docs_; freqs_ = other.freqs_;
+        windowSize_ = other.windowSize_; pos_ = other.pos_; size_ = other.size_;
+        maxFreq_ = other.maxFreq_;
+        blockData_ = other.blockData_; blockEnd_ = other.blockEnd_; skips_ = other.skips_;
+        fullBlocks_ = other.fullBlocks_; block_ = other.block_; tailMax_ = other.tailMax_;
+        if (blockData_) {
+            std::copy(other.docBuf_, other.docBuf_ + windowSize_, docBuf_);
+            std::copy(other.freqBuf_, other.freqBuf_ + windowSize_, freqBuf_);
+            docs_ = docBuf_;
+            freqs_ = freqBuf_;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Cursor over a block-format list of length postings in
+     * [data, data + bytes). A length that cannot fit gives an empty
+     * cursor; a block that turns out corrupt ends the cursor there.
+     */
+    static PostingCursor fromBlocks(const uint8_t* data, size_t bytes, uint32_t length) {
+        PostingCursor c;
+        if (bytes < minBlockListBytes(length)) return c;
+        c.blockData_ = data;
+        c.blockEnd_ = data + bytes;
+        c.size_ = length;
+        c.fullBlocks_ = length / POSTING_BLOCK_SIZE;
+        c.skips_ = reinterpret_cast<const BlockSkipEntry*>(data);
+        c.loadBlock(0);
+        return c;
+    }
+
+    uint32_t size() const { return size_; }
+    bool atEnd() const { return pos_ >= windowSize_; }
+    uint32_t docID() const { return docs_[pos_]; }
+    uint32_t freq() const { return freqs_[pos_]; }
+
+    void next() {
+        if (++pos_ >= windowSize_ && blockData_ && block_ < fullBlocks_)
+            loadBlock(block_ + 1);
+    }
+
+    /**
+     * @brief Moves to the first posting with docID >= target.
+     * @return true if that posting's docID equals target.
+     */
+    bool advance(uint32_t target) {
+        if (atEnd()) return false;
+        if (docs_[pos_] >= target) return docs_[pos_] == target;
+
+        if (blockData_ && block_ < fullBlocks_ && skips_[block_].lastDocID < target) {
+            // Skip whole blocks using their last docID
+            uint32_t b = block_ + 1;
+            while (b < fullBlocks_ && skips_[b].lastDocID < target) ++b;
+            loadBlock(b);
+        }
+
+        // Gallop inside the current window, then binary-search the bracket
+        for (;;) {
+            uint32_t step = 1, lo = pos_;
+            while (lo + step < windowSize_ && docs_[lo + step] < target) {
+                lo += step;
+                step <<= 1;
+            }
+            uint32_t hi = std::min(lo + step, windowSize_);
+            pos_ = static_cast<uint32_t>(std::lower_bound(docs_ + lo, docs_ + hi, target) - docs_);
+
+            if (pos_ < windowSize_ || !blockData_ || block_ >= fullBlocks_) break;
+            loadBlock(block_ + 1); // target is past this block
+        }
+        return !atEnd() && docs_[pos_] == target;
+    }
+
+    // -------------------- SCORE BOUNDS --------------------
+    // Upper bounds on freq() for dynamic pruning (Wand.hpp). Neither moves
+    // the cursor. A block's bound comes from the freq bit width in its
+    // header, so no block is decoded; span mode has one bound for the list.
+
+    /**
+     * @brief Largest freq in the list (an upper bound in block mode).
+     * Worked out on first use unless the span recorded it.
+     */
+    uint32_t maxFreq() {
+        if (maxFreq_ || size_ == 0) return maxFreq_;
+        if (!blockData_) {
+            maxFreq_ = *std::max_element(freqs_, freqs_ + size_);
+            return maxFreq_;
+        }
+        for (uint32_t b = 0; b < fullBlocks_; ++b)
+            maxFreq_ = std::max(maxFreq_, blockFreqBound(b));
+        maxFreq_ = std::max(maxFreq_, tailMaxFreq());
+        return maxFreq_;
+    }
+
+    /**
+     * @brief Bound on freq within the block that holds the first posting
+     * >= target (at or after the current block); lastDocID receives that
+     * block's last docID. In span mode the "block" is the whole list.
+     */
+    uint32_t blockMaxFreq(uint32_t target, uint32_t& lastDocID) {
+        if (!blockData_) {
+            lastDocID = std::numeric_limits<uint32_t>::max();
+            return maxFreq();
+        }
+        const BlockSkipEntry* it = std::lower_bound(
+            skips_ + std::min(block_, fullBlocks_), skips_ + fullBlocks_, target,
+            [](const BlockSkipEntry& e, uint32_t t) { return e.lastDocID < t; });
+        uint32_t b = static_cast<uint32_t>(it - skips_);
+        if (b < fullBlocks_) {
+            lastDocID = skips_[b].lastDocID;
+            return blockFreqBound(b);
+        }
+        lastDocID = std::numeric_limits<uint32_t>::max();
+        return tailMaxFreq();
+    }
+
+    // -------------------- PARTITIONING --------------------
+    /**
+     * @brief Appends up to parts - 1 ascending docIDs that cut the list
+     * into runs of about size() / parts postings, for splitting a query
+     * into docID ranges. Block mode cuts at block starts, read from the
+     * skip entries without decoding. Does not move the cursor. Points not
+     * above out.back() are dropped, so out stays strictly ascending.
+     */
+    template <typename DocIDs>
+    void splitPoints(unsigned parts, DocIDs& out) const {
+        if (size_ == 0) return;
+        for (unsigned i = 1; i < parts; ++i) {
+            uint32_t posting = static_cast<uint32_t>(static_cast<uint64_t>(size_) * i / parts);
+            uint32_t doc;
+            if (!blockData_) {
+                doc = docs_[posting];
+            } else {
+                uint32_t block = posting / POSTING_BLOCK_SIZE;
+                if (block == 0) continue;
+                if (block > fullBlocks_) break;
+                doc = skips_[block - 1].lastDocID + 1; // first docID of that block or later
+            }
+            if (out.empty() || doc > out.back()) out.push_back(doc);
+        }
+    }
+
+private:
+    // All-ones of the block's freq bit width, read from its header word
+    // (no bound at all for a corrupt block)
+    uint32_t blockFreqBound(uint32_t block) const {
+        const uint32_t* words = packedBlock(blockData_, blockEnd_, size_, block);
+        if (!words) return std::numeric_limits<uint32_t>::max();
+        uint32_t freqBits = (words[0] >> 8) & 0xFF;
+        return freqBits >= 32 ? std::numeric_limits<uint32_t>::max() : (1u << freqBits) - 1;
+    }
+
+    // The VByte tail has no header; it is at most 127 postings, decoded once
+    uint32_t tailMaxFreq() {
+        if (tailMax_ == 0 && size_ % POSTING_BLOCK_SIZE) {
+            uint32_t docs[POSTING_BLOCK_SIZE], freqs[POSTING_BLOCK_SIZE];
+            tailMax_ = decodeBlockTail(blockData_, blockEnd_, size_, docs, freqs)
+                     ? *std::max_element(freqs, freqs + size_ % POSTING_BLOCK_SIZE)
+                     : std::numeric_limits<uint32_t>::max();
+        }
+        return tailMax_;
+    }
+
+    // block == fullBlocks_ selects the VByte tail. A block that does not
+    // decode leaves an empty window on the tail, so the cursor is at its end.
+    void loadBlock(uint32_t block) {
+        block_ = block;
+        pos_ = 0;
+        if (block < fullBlocks_) {
+            windowSize_ = decodeBlock(blockData_, blockEnd_, size_, block, docBuf_, freqBuf_)
+                        ? POSTING_BLOCK_SIZE : 0;
+        } else {
+            windowSize_ = decodeBlockTail(blockData_, blockEnd_, size_, docBuf_, freqBuf_)
+                        ? size_ % POSTING_BLOCK_SIZE : 0;
+        }
+        if (windowSize_ == 0) block_ = fullBlocks_;
+        docs_ = docBuf_;
+        freqs_ = freqBuf_;
+    }
+
+    // Current window: the whole span, or the decoded block
+    const uint32_t* docs_ = nullptr;
+    const uint32_t* freqs_ = nullptr;
+    uint32_t windowSize_ = 0;
+    uint32_t pos_ = 0;
+    uint32_t size_ = 0;
+    uint32_t maxFreq_ = 0;   // 0 until known
+
+    // Block mode only
+    const uint8_t* blockData_ = nullptr;
+    const uint8_t* blockEnd_ = nullptr;
+    const BlockSkipEntry* skips_ = nullptr;
+    uint32_t fullBlocks_ = 0;
+    uint32_t block_ = 0;
+    uint32_t tailMax_ = 0;
+    uint32_t docBuf_[POSTING_BLOCK_SIZE];
+    uint32_t freqBuf_[POSTING_BLOCK_SIZE];
+};
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "BinaryBarrel.hpp"
+#include "PostingCursor.hpp"
+#include "PositionIndex.hpp"
+#include "Conjunction.hpp"
+#include "QueryParser.hpp"
+#include "BM25.hpp"
+
+// =================================================================
+// BOOLEAN QUERY ITERATORS
+// =================================================================
+//
+// A parsed query (QueryParser.hpp) compiles into a tree of iterators that
+// all walk matching docIDs in ascending order with the PostingCursor
+// interface: atEnd / docID / next / advance(target). Nothing is
+// materialized:
+//
+//   TermIterator  one posting list
+//   AndIterator   a Conjunction of its required children, led by the one
+//                 with the lowest cost; each candidate is then checked
+//                 against the excluded children by advance()ing them to it,
+//                 so NOT skips through its lists instead of building a
+//                 set difference
+//   OrIterator    the smallest docID among its children
+//   PhraseIterator  a Conjunction of its words; only the documents that
+//                 survive it have their positions read and checked
+//
+// cost() estimates how many documents an iterator yields (DF for a term,
+// the cheapest required child for AND, the sum for OR); compileQuery()
+// uses it to order children.
+
+class QueryIterator {
+public:
+    virtual ~QueryIterator() = default;
+
+    virtual bool atEnd() const = 0;
+    virtual uint32_t docID() const = 0;
+    virtual void next() = 0;
+
+    // Moves to the first match with docID >= target; true if it is target
+    virtual bool advance(uint32_t target) = 0;
+
+    virtual uint32_t cost() const = 0;
+
+    // Adds the BM25 share of every non-negated term sitting on doc to
+    // score, and counts those terms in matched
+    virtual void collect(uint32_t doc, const BM25& model, float& score, int& matched) const = 0;
+
+protected:
+    bool on(uint32_t doc) const { return !atEnd() && docID() == doc; }
+};
+
+// One query word. The cursor may point into scratch (decoded compressed
+// barrels), so terms are heap-allocated and never move. positions is only
+// filled for words of a phrase.
+class TermIterator : public QueryIterator {
+public:
+    PostingCursor cursor;
+    BarrelPostings scratch;
+    PositionCursor positions;
+    uint32_t df = 0;
+    float idf = 0.0f;
+
+    bool atEnd() const override { return cursor.atEnd(); }
+    uint32_t docID() const override { return cursor.docID(); }
+    void next() override { cursor.next(); }
+    bool advance(uint32_t target) override { return cursor.advance(target); }
+    uint32_t cost() const override { return df; }
+
+    void collect(uint32_t doc, const BM25& model, float& score, int& matched) const override {
+        if (!on(doc)) return;
+        score += model.termScore(idf, cursor.freq(), doc);
+        ++matched;
+    }
+};
+
+class AndIterator : public QueryIterator {
+public:
+    AndIterator(std::vector<std::unique_ptr<QueryIterator>> required,
+                std::vector<std::unique_ptr<QueryIterator>> excluded)
+        : required_(std::move(required)), excluded_(std::move(excluded)),
+          match_(pointers(required_), costs(required_))
+    {
+        // Likeliest to hold a candidate first, so a rejection is found early
+        std::stable_sort(excluded_.begin(), excluded_.end(),
+                         [](const std::unique_ptr<QueryIterator>& a, const std::unique_ptr<QueryIterator>& b) {
+                             return a->cost() > b->cost();
+                         });
+        skipExcluded();
+    }
+
+    bool atEnd() const override { return match_.atEnd(); }
+    uint32_t docID() const override { return match_.docID(); }
+
+    void next() override {
+        match_.next();
+        skipExcluded();
+    }
+
+    bool advance(uint32_t target) override {
+        match_.advance(target);
+        skipExcluded();
+        return on(target);
+    }
+
+    uint32_t cost() const override { return match_.cost(); }
+
+    void collect(uint32_t doc, const BM25& model, float& score, int& matched) const override {
+        if (!on(doc)) return;
+        for (const auto& r : required_) r->collect(doc, model, score, matched);
+    }
+
+private:
+    static std::vector<QueryIterator*> pointers(const std::vector<std::unique_ptr<QueryIterator>>& its) {
+        std::vector<QueryIterator*> out;
+        for (const auto& it : its) out.push_back(it.get());
+        return out;
+    }
+
+    static std::vector<uint32_t> costs(const std::vector<std::unique_ptr<QueryIterator>>& its) {
+        std::vector<uint32_t> out;
+        for (const auto& it : its) out.push_back(it->cost());
+        return out;
+    }
+
+    // Candidates ascend, so every excluded iterator only ever moves forward
+    void skipExcluded() {
+        while (!match_.atEnd() && isExcluded(match_.docID())) match_.next();
+    }
+
+    bool isExcluded(uint32_t doc) {
+        for (auto& e : excluded_)
+            if (e->advance(doc)) return true;
+        return false;
+    }
+
+    std::vector<std::unique_ptr<QueryIterator>> required_;
+    std::vector<std::unique_ptr<QueryIterator>> excluded_;
+    Conjunction<QueryIterator> match_;
+};
+
+class OrIterator : public QueryIterator {
+public:
+    explicit OrIterator(std::vector<std::unique_ptr<QueryIterator>> children)
+        : children_(std::move(children))
+    {
+        for (const auto& c : children_) cost_ += c->cost();
+        settle();
+    }
+
+    bool atEnd() const override { return doc_ == NO_DOC; }
+    uint32_t docID() const override { return doc_; }
+
+    void next() override {
+        if (atEnd()) return;
+        for (auto& c : children_)
+            if (on(*c, doc_)) c->next();
+        settle();
+    }
+
+    bool advance(uint32_t target) override {
+        if (atEnd()) return false;
+        if (doc_ < target) {
+            for (auto& c : children_)
+                if (!c->atEnd() && c->docID() < target) c->advance(target);
+            settle();
+        }
+        return doc_ == target;
+    }
+
+    uint32_t cost() const override { return cost_; }
+
+    void collect(uint32_t doc, const BM25& model, float& score, int& matched) const override {
+        if (doc_ != doc) return;
+        for (const auto& c : children_) c->collect(doc, model, score, matched);
+    }
+
+private:
+    static constexpr uint32_t NO_DOC = std::numeric_limits<uint32_t>::max();
+
+    static bool on(const QueryIterator& c, uint32_t doc) { return !c.atEnd() && c.docID() == doc; }
+
+    void settle() {
+        doc_ = NO_DOC;
+        for (const auto& c : children_)
+            if (!c->atEnd()) doc_ = std::min(doc_, c->docID());
+    }
+
+    std::vector<std::unique_ptr<QueryIterator>> children_;
+    uint32_t cost_ = 0;
+    uint32_t doc_ = NO_DOC;
+};
+
+class PhraseIterator : public QueryIterator {
+public:
+    // terms in phrase order; slop as in QueryNode
+    PhraseIterator(std::vector<std::unique_ptr<TermIterator>> terms, uint32_t slop)
+        : terms_(std::move(terms)), slop_(slop), found_(terms_.size()), next_(terms_.size()),
+          match_(pointers(terms_), costs(terms_))
+    {
+        skipMismatches();
+    }
+
+    bool atEnd() const override { return match_.atEnd(); }
+    uint32_t docID() const override { return match_.docID(); }
+
+    void next() override {
+        match_.next();
+        skipMismatches();
+    }
+
+    bool advance(uint32_t target) override {
+        match_.advance(target);
+        skipMismatches();
+        return on(target);
+    }
+
+    uint32_t cost() const override { return match_.cost(); }
+
+    void collect(uint32_t doc, const BM25& model, float& score, int& matched) const override {
+        if (!on(doc)) return;
+        for (const auto& t : terms_) t->collect(doc, model, score, matched);
+    }
+
+private:
+    static std::vector<QueryIterator*> pointers(const std::vector<std::unique_ptr<TermIterator>>& terms) {
+        std::vector<QueryIterator*> out;
+        for (const auto& t : terms) out.push_back(t.get());
+        return out;
+    }
+
+    static std::vector<uint32_t> costs(const std::vector<std::unique_ptr<TermIterator>>& terms) {
+        std::vector<uint32_t> out;
+        for (const auto& t : terms) out.push_back(t->cost());
+        return out;
+    }
+
+    void skipMismatches() {
+        while (!match_.atEnd() && !inPhrase(match_.docID())) match_.next();
+    }
+
+    // True if doc holds the words in order within slop. A word without
+    // positions (index built without positions.pos) cannot be checked, so
+    // the phrase then degrades to plain AND.
+    bool inPhrase(uint32_t doc) {
+        for (size_t i = 0; i < terms_.size(); ++i) {
+            if (!terms_[i]->positions.available()) return true;
+            if (!terms_[i]->positions.positions(doc, found_[i])) return false;
+            next_[i] = 0;
+        }
+
+        // For each start, take the earliest position of every following
+        // word after the previous one; that chain ends as early as any can.
+        // Starts ascend, so the per-word indexes only move forward.
+        const uint32_t gaps = static_cast<uint32_t>(terms_.size() - 1);
+        for (uint32_t start : found_[0]) {
+            uint32_t prev = start;
+            for (size_t i = 1; i < terms_.size(); ++i) {
+                const std::vector<uint32_t>& at = found_[i];
+                size_t& j = next_[i];
+                while (j < at.size() && at[j] <= prev) ++j;
+                if (j == at.size()) return false;
+                prev = at[j];
+            }
+            if (prev - start - gaps <= slop_) return true;
+        }
+        return false;
+    }
+
+    std::vector<std::unique_ptr<TermIterator>> terms_;
+    uint32_t slop_;
+    std::vector<std::vector<uint32_t>> found_;   // positions of each word in the candidate
+    std::vector<size_t> next_;
+    Conjunction<QueryIterator> match_;
+};
+
+// Fills a TermIterator in place with the postings, DF and IDF of word, and its
+// positions if positional (a phrase word); leaves it empty if the word is
+// unknown
+using TermResolver = std::function<void(const std::string& word, TermIterator& term, bool positional)>;
+
+/**
+ * @brief Compiles a parsed query (parseQuery() accepted it) into iterators.
+ *
+ * Optimizes while building: single-child groups collapse, children that
+ * match nothing are dropped from OR and from exclusion lists (an empty
+ * required child empties its AND at once), AND children are led by the
+ * lowest cost and exclusions are probed most-likely-first.
+ */
+inline std::unique_ptr<QueryIterator> compileQuery(const QueryNode& node, const TermResolver& resolve)
+{
+    switch (node.kind) {
+        case QueryNode::Term: {
+            auto term = std::make_unique<TermIterator>();
+            resolve(node.word, *term, false);
+            return term;
+        }
+        case QueryNode::Phrase: {
+            std::vector<std::unique_ptr<TermIterator>> terms;
+            for (const auto& c : node.children) {
+                terms.push_back(std::make_unique<TermIterator>());
+                resolve(c.word, *terms.back(), true);
+            }
+            return std::make_unique<PhraseIterator>(std::move(terms), node.slop);
+        }
+        case QueryNode::Or: {
+            std::vector<std::unique_ptr<QueryIterator>> children;
+            for (const auto& c : node.children) {
+                auto it = compileQuery(c, resolve);
+                if (!it->atEnd()) children.push_back(std::move(it));
+            }
+            if (children.size() == 1) return std::move(children[0]);
+            return std::make_unique<OrIterator>(std::move(children));
+        }
+        case QueryNode::And: {
+            std::vector<std::unique_ptr<QueryIterator>> required, excluded;
+            for (const auto& c : node.children) {
+                if (c.kind == QueryNode::Not) {
+                    auto it = compileQuery(c.children[0], resolve);
+                    if (!it->atEnd()) excluded.push_back(std::move(it));
+                } else {
+                    required.push_back(compileQuery(c, resolve));
+                }
+            }
+            if (required.size() == 1 && excluded.empty()) return std::move(required[0]);
+            return std::make_unique<AndIterator>(std::move(required), std::move(excluded));
+        }
+        case QueryNode::Not:
+            break; // rejected by the parser outside an AND
+    }
+    return std::make_unique<OrIterator>(std::vector<std::unique_ptr<QueryIterator>>{});
+}
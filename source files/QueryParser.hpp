@@ -0,0 +1,324 @@
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// =================================================================
+// BOOLEAN QUERY PARSER
+// =================================================================
+//
+//   query   := orExpr
+//   orExpr  := andExpr ( OR andExpr )*
+//   andExpr := unary ( [AND] unary )*        adjacent terms are ANDed
+//   unary   := NOT unary | -unary | +unary | ( orExpr ) | phrase | word
+//   phrase  := "word word ..." [~N]
+//
+// AND / OR / NOT are operators only in upper case; "and" is a word. Words
+// are lowercased like tokenize(). "-word" / "-( ... )" excludes, and
+// "+word" marks a word required, which it already is under the implicit
+// AND (accepted so pasted search-engine syntax keeps working).
+//
+// A quoted phrase matches its words in order and adjacent; with ~N, in
+// order with at most N other words between them in total. A one-word
+// phrase is just the word.
+//
+// There is no "all documents" list, so every document must be reached
+// through a term that is not negated: "NOT a" alone, or an OR branch that
+// is only a negation, is rejected.
+//
+// parsePhraseQuery() reads the plain implicit-AND syntax instead: only
+// phrases are recognized, and every other word is a term as tokenize()
+// splits it, operators and signs included.
+
+// Reads a "~N" slop suffix at text[i] (just past a closing quote), if any
+inline uint32_t readPhraseSlop(const std::string& text, size_t& i) {
+    uint32_t slop = 0;
+    if (i + 1 < text.size() && text[i] == '~' && std::isdigit(static_cast<unsigned char>(text[i + 1]))) {
+        for (++i; i < text.size() && std::isdigit(static_cast<unsigned char>(text[i])); ++i)
+            slop = std::min<uint32_t>(slop * 10 + (text[i] - '0'), 1000000);
+    }
+    return slop;
+}
+
+struct QueryNode {
+    enum Kind { Term, And, Or, Not, Phrase };
+
+    Kind kind = Term;
+    std::string word;                  // Term
+    std::vector<QueryNode> children;   // And / Or; Not has exactly one; Phrase its Terms
+    uint32_t slop = 0;                 // Phrase: words allowed between the phrase's words
+};
+
+class QueryParser {
+public:
+    explicit QueryParser(const std::string& text) { lex(text); }
+
+    /**
+     * @brief Parses the query into root (AND / OR groups flattened).
+     * @return false with a message in error on a syntax error.
+     */
+    bool parse(QueryNode& root, std::string& error) {
+        pos_ = 0;
+        error_.clear();
+        if (!lexError_.empty()) return fail(error, lexError_);
+        if (tokens_.empty()) return fail(error, "Empty query");
+
+        root = parseOr();
+        if (error_.empty() && pos_ < tokens_.size()) error_ = "Unexpected ')'";
+        if (!error_.empty()) return fail(error, error_);
+        if (!reachable(root)) return fail(error, "A query needs a term that is not negated");
+        return true;
+    }
+
+private:
+    enum TokenKind { Word, Open, Close, OpAnd, OpOr, OpNot, Plus, Minus, Quoted };
+    struct Token {
+        Token(TokenKind kind, std::string text) : kind(kind), text(std::move(text)) {}
+
+        TokenKind kind;
+        std::string text;
+        std::vector<std::string> words;   // Quoted
+        uint32_t slop = 0;                // Quoted
+    };
+
+    // -------------------- LEXER --------------------
+    void lex(const std::string& text) {
+        size_t i = 0;
+        while (i < text.size()) {
+            char c = text[i];
+            if (std::isspace(static_cast<unsigned char>(c))) { ++i; continue; }
+            if (c == '(') { tokens_.push_back({Open, ""}); ++i; continue; }
+            if (c == ')') { tokens_.push_back({Close, ""}); ++i; continue; }
+            if (c == '"') {
+                if (!lexPhrase(text, i)) return;
+                continue;
+            }
+            // A sign only prefixes; "e-mail" stays one word
+            if ((c == '+' || c == '-') && i + 1 < text.size() &&
+                !std::isspace(static_cast<unsigned char>(text[i + 1])))
+            {
+                tokens_.push_back({c == '+' ? Plus : Minus, ""});
+                ++i;
+                continue;
+            }
+
+            size_t start = i;
+            while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i])) &&
+                   text[i] != '(' && text[i] != ')')
+                ++i;
+            std::string word = text.substr(start, i - start);
+
+            if (word == "AND") tokens_.push_back({OpAnd, ""});
+            else if (word == "OR") tokens_.push_back({OpOr, ""});
+            else if (word == "NOT") tokens_.push_back({OpNot, ""});
+            else {
+                std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+                tokens_.push_back({Word, word});
+            }
+        }
+    }
+
+    // Reads "..."[~N] starting at the opening quote
+    bool lexPhrase(const std::string& text, size_t& i) {
+        size_t close = text.find('"', i + 1);
+        if (close == std::string::npos) {
+            lexError_ = "Missing closing '\"'";
+            return false;
+        }
+
+        Token t{Quoted, ""};
+        std::string word;
+        for (size_t j = i + 1; j <= close; ++j) {
+            if (j < close && !std::isspace(static_cast<unsigned char>(text[j]))) {
+                word += static_cast<char>(std::tolower(static_cast<unsigned char>(text[j])));
+            } else if (!word.empty()) {
+                t.words.push_back(word);
+                word.clear();
+            }
+        }
+        if (t.words.empty()) {
+            lexError_ = "Empty phrase";
+            return false;
+        }
+
+        i = close + 1;
+        t.slop = readPhraseSlop(text, i);
+        tokens_.push_back(std::move(t));
+        return true;
+    }
+
+    // -------------------- GRAMMAR --------------------
+    bool at(TokenKind kind) const { return pos_ < tokens_.size() && tokens_[pos_].kind == kind; }
+
+    QueryNode parseOr() {
+        QueryNode node = parseAnd();
+        while (error_.empty() && at(OpOr)) {
+            ++pos_;
+            node = combine(QueryNode::Or, std::move(node), parseAnd());
+        }
+        return node;
+    }
+
+    QueryNode parseAnd() {
+        QueryNode node = parseUnary();
+        while (error_.empty() && pos_ < tokens_.size() && !at(OpOr) && !at(Close)) {
+            if (at(OpAnd)) ++pos_;
+            node = combine(QueryNode::And, std::move(node), parseUnary());
+        }
+        return node;
+    }
+
+    QueryNode parseUnary() {
+        if (pos_ >= tokens_.size()) { error_ = "Query ends where a term was expected"; return {}; }
+
+        const Token& t = tokens_[pos_++];
+        switch (t.kind) {
+            case Word: {
+                QueryNode node;
+                node.word = t.text;
+                return node;
+            }
+            case OpNot:
+            case Minus: {
+                QueryNode node;
+                node.kind = QueryNode::Not;
+                node.children.push_back(parseUnary());
+                return node;
+            }
+            case Quoted: {
+                QueryNode node;
+                node.kind = QueryNode::Phrase;
+                node.slop = t.slop;
+                for (const auto& w : t.words) {
+                    QueryNode term;
+                    term.word = w;
+                    node.children.push_back(std::move(term));
+                }
+                if (node.children.size() == 1) return std::move(node.children[0]);
+                return node;
+            }
+            case Plus:
+                return parseUnary();
+            case Open: {
+                QueryNode node = parseOr();
+                if (error_.empty() && !at(Close)) error_ = "Missing ')'";
+                ++pos_;
+                return node;
+            }
+            default:
+                error_ = (t.kind == Close) ? "Unexpected ')'" : "Operator without a term before it";
+                return {};
+        }
+    }
+
+    // Appends right to a kind group, merging nested groups of the same kind
+    static QueryNode combine(QueryNode::Kind kind, QueryNode left, QueryNode right) {
+        QueryNode node;
+        node.kind = kind;
+        for (QueryNode* part : {&left, &right}) {
+            if (part->kind == kind) {
+                for (auto& c : part->children) node.children.push_back(std::move(c));
+            } else {
+                node.children.push_back(std::move(*part));
+            }
+        }
+        return node;
+    }
+
+    // True if the node's matches all come from some non-negated term
+    static bool reachable(const QueryNode& node) {
+        switch (node.kind) {
+            case QueryNode::Term:
+            case QueryNode::Phrase: return true;
+            case QueryNode::Not:  return false;
+            case QueryNode::And: {
+                // Exclusions need a listable inner query, and one part must be positive
+                bool positive = false;
+                for (const auto& c : node.children) {
+                    if (!reachable(c.kind == QueryNode::Not ? c.children[0] : c)) return false;
+                    positive |= c.kind != QueryNode::Not;
+                }
+                return positive;
+            }
+            case QueryNode::Or:
+                return std::all_of(node.children.begin(), node.children.end(), reachable);
+        }
+        return false;
+    }
+
+    bool fail(std::string& error, const std::string& message) {
+        error = message;
+        return false;
+    }
+
+    std::vector<Token> tokens_;
+    size_t pos_ = 0;
+    std::string error_;
+    std::string lexError_;
+};
+
+/**
+ * @brief Parses a boolean query; see QueryParser for the syntax.
+ */
+inline bool parseQuery(const std::string& text, QueryNode& root, std::string& error) {
+    return QueryParser(text).parse(root, error);
+}
+
+/**
+ * @brief Parses an implicit-AND query with quoted phrases into root: each
+ * "..."[~N] becomes a phrase as under parseQuery(), every other word a
+ * term. AND / OR / NOT, signs and parentheses are ordinary words here.
+ * @return false if a quote is left open or no quoted part holds a word;
+ *         the query is then plain tokens.
+ */
+inline bool parsePhraseQuery(const std::string& text, QueryNode& root) {
+    QueryNode all;
+    all.kind = QueryNode::And;
+    bool quoted = false;
+
+    // Whitespace-separated, lowercased words of text[from, to)
+    auto addWords = [&](size_t from, size_t to, std::vector<QueryNode>& out) {
+        size_t i = from;
+        while (i < to) {
+            while (i < to && std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+            size_t start = i;
+            while (i < to && !std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+            if (i == start) break;
+            QueryNode term;
+            term.word = text.substr(start, i - start);
+            std::transform(term.word.begin(), term.word.end(), term.word.begin(), ::tolower);
+            out.push_back(std::move(term));
+        }
+    };
+
+    size_t i = 0;
+    while (i < text.size()) {
+        size_t open = text.find('"', i);
+        if (open == std::string::npos) {
+            addWords(i, text.size(), all.children);
+            break;
+        }
+        size_t close = text.find('"', open + 1);
+        if (close == std::string::npos) return false;
+
+        addWords(i, open, all.children);
+        QueryNode phrase;
+        phrase.kind = QueryNode::Phrase;
+        addWords(open + 1, close, phrase.children);
+        i = close + 1;
+        phrase.slop = readPhraseSlop(text, i);
+
+        if (phrase.children.empty()) continue;
+        quoted = true;
+        if (phrase.children.size() == 1) all.children.push_back(std::move(phrase.children[0]));
+        else all.children.push_back(std::move(phrase));
+    }
+    if (!quoted) return false;
+
+    if (all.children.size() == 1) root = std::move(all.children[0]);
+    else root = std::move(all);
+    return true;
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+#include "BinaryBarrel.hpp"
+
+// =================================================================
+// PER-THREAD QUERY SCRATCH
+// =================================================================
+//
+// Everything a query needs only while it runs, kept per thread and reused
+// from one query to the next instead of allocated fresh each time:
+//
+//   QueryArena        a monotonic std::pmr arena for the per-query arrays
+//                     (words, cursors, costs, IDFs, the top-k heap, the
+//                     evaluators' working lists). Allocation is a pointer
+//                     bump; the whole arena is rewound when the query ends.
+//   ScoreAccumulator  a dense float array indexed by docID for
+//                     term-at-a-time scoring, with the list of touched
+//                     docIDs so that clearing it costs what the query
+//                     touched, not the collection size.
+//   decode buffers    for postings of compressed barrels that BarrelStore
+//                     decodes (see BarrelStore::fetch()).
+//
+// All three only grow, up to what the largest query so far needed, so a
+// warm thread answers queries without touching the global allocator
+// (only the returned results are allocated). A query opens a
+// QueryScratch::Scope before declaring any arena container; the outermost
+// scope rewinds everything once they are gone.
+
+/**
+ * @brief Monotonic arena over an owned buffer. When a query spills past
+ * the buffer (the overflow comes from the heap), the buffer is enlarged to
+ * cover it at the next rewind.
+ */
+class QueryArena {
+public:
+    explicit QueryArena(size_t initialBytes = 64 * 1024) : buffer_(initialBytes) { rewind(); }
+
+    QueryArena(const QueryArena&) = delete;
+    QueryArena& operator=(const QueryArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*arena_; }
+
+    size_t capacity() const { return buffer_.size(); }
+
+    // Frees everything handed out since the last rewind
+    void rewind() {
+        arena_.reset(); // returns any spill to the heap
+        if (spill_.bytes > 0) {
+            buffer_.resize(buffer_.size() + spill_.bytes);
+            spill_.bytes = 0;
+        }
+        arena_.emplace(buffer_.data(), buffer_.size(), &spill_);
+    }
+
+private:
+    // Upstream of the arena: the heap, counting what the buffer missed
+    struct Spill : std::pmr::memory_resource {
+        size_t bytes = 0;
+
+        void* do_allocate(size_t n, size_t align) override {
+            bytes += n;
+            return std::pmr::new_delete_resource()->allocate(n, align);
+        }
+        void do_deallocate(void* p, size_t n, size_t align) override {
+            std::pmr::new_delete_resource()->deallocate(p, n, align);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    std::vector<std::byte> buffer_;
+    Spill spill_;
+    std::optional<std::pmr::monotonic_buffer_resource> arena_;
+};
+
+/**
+ * @brief Dense docID -> score array. add() records each docID the first
+ * time it is touched; reset() zeroes only those.
+ */
+class ScoreAccumulator {
+public:
+    void add(uint32_t docID, float score) {
+        if (docID >= scores_.size()) {
+            scores_.resize(docID + 1, 0.0f);
+            seen_.resize(docID + 1, 0);
+        }
+        if (!seen_[docID]) {
+            seen_[docID] = 1;
+            touched_.push_back(docID);
+        }
+        scores_[docID] += score;
+    }
+
+    float score(uint32_t docID) const { return docID < scores_.size() ? scores_[docID] : 0.0f; }
+
+    // docIDs with a score, in the order they were first touched
+    const std::vector<uint32_t>& touched() const { return touched_; }
+
+    void reset() {
+        for (uint32_t d : touched_) {
+            scores_[d] = 0.0f;
+            seen_[d] = 0;
+        }
+        touched_.clear();
+    }
+
+private:
+    std::vector<float> scores_;
+    std::vector<uint8_t> seen_;
+    std::vector<uint32_t> touched_;
+};
+
+class QueryScratch {
+public:
+    // The calling thread's scratch
+    static QueryScratch& local() {
+        thread_local QueryScratch scratch;
+        return scratch;
+    }
+
+    std::pmr::memory_resource* memory() { return arena_.resource(); }
+    ScoreAccumulator& scores() { return scores_; }
+
+    // A decode buffer no one else uses before the query ends
+    BarrelPostings& decodeBuffer() {
+        if (decodeUsed_ == decode_.size()) decode_.emplace_back();
+        return decode_[decodeUsed_++];
+    }
+
+    size_t arenaCapacity() const { return arena_.capacity(); }
+
+    /**
+     * @brief One query's lifetime. Scopes nest (a query may run another);
+     * the outermost one rewinds the arena and clears the accumulator.
+     */
+    class Scope {
+    public:
+        explicit Scope(QueryScratch& scratch = QueryScratch::local()) : scratch_(scratch) { ++scratch_.depth_; }
+        ~Scope() { if (--scratch_.depth_ == 0) scratch_.reset(); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        QueryScratch& scratch() const { return scratch_; }
+        std::pmr::memory_resource* memory() const { return scratch_.memory(); }
+
+    private:
+        QueryScratch& scratch_;
+    };
+
+private:
+    QueryScratch() = default;
+
+    void reset() {
+        arena_.rewind();
+        scores_.reset();
+        decodeUsed_ = 0;
+    }
+
+    QueryArena arena_;
+    ScoreAccumulator scores_;
+    std::deque<BarrelPostings> decode_;   // a deque: handed-out buffers never move
+    size_t decodeUsed_ = 0;
+    int depth_ = 0;
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include "FrequencySketch.hpp"
+
+// =================================================================
+// QUERY RESULT CACHE
+// =================================================================
+//
+// Final top-k lists of recent queries, keyed by the normalized query
+// (tokens, mode and k; see queryCacheKey() in new_Semantic.cpp), stored as
+// two compact arrays. A hit costs one hash lookup and a copy of k results.
+//
+// Bounded by a byte budget, like BarrelCache, but admission is frequency
+// aware (TinyLFU): every lookup is counted in a FrequencySketch, and
+// once the cache is full a new list only gets in if its query is asked
+// more often than each entry it would evict from the LRU end. A
+// burst of one-off queries therefore cannot flush the queries users keep
+// repeating.
+//
+// Entries carry the index generation they were computed at. The engine
+// bumps its generation on every change to the index or to scoring, and
+// an entry of an older generation counts as a miss and is dropped.
+// Every call takes the cache's lock, so concurrent searches may share it.
+
+struct ResultCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;       // includes stale entries
+    uint64_t stale = 0;        // entries dropped for an older generation
+    uint64_t admissions = 0;
+    uint64_t rejections = 0;   // lists refused by frequency admission
+    uint64_t evictions = 0;
+    size_t bytes = 0;
+    size_t budget = 0;
+    size_t entries = 0;
+
+    double hitRatio() const {
+        uint64_t lookups = hits + misses;
+        return lookups ? static_cast<double>(hits) / lookups : 0.0;
+    }
+};
+
+/**
+ * @brief LRU cache of top-k lists with frequency-aware admission.
+ * Result is any struct with docID and score members.
+ */
+template <typename Result>
+class ResultCache {
+public:
+    using Score = decltype(Result::score);
+
+    explicit ResultCache(size_t budgetBytes = 8u << 20) { stats_.budget = budgetBytes; }
+
+    /**
+     * @brief Copies the cached list of key into out if there is one of the
+     * given generation. Counts the access either way.
+     */
+    bool lookup(const std::string& key, uint64_t generation, std::vector<Result>& out) {
+        size_t hash = std::hash<std::string>{}(key);
+        std::lock_guard<std::mutex> lock(mutex_);
+        sketch_.record(hash);
+
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            stats_.misses++;
+            return false;
+        }
+        if (it->second->generation != generation) {
+            stats_.stale++;
+            stats_.misses++;
+            erase(it->second);
+            return false;
+        }
+
+        stats_.hits++;
+        lru_.splice(lru_.begin(), lru_, it->second); // mark most recently used
+        const Entry& e = *it->second;
+        out.resize(e.docIDs.size());
+        for (size_t i = 0; i < e.docIDs.size(); ++i)
+            out[i] = {static_cast<int>(e.docIDs[i]), e.scores[i]};
+        return true;
+    }
+
+    /**
+     * @brief Offers the results of key (just looked up and missed). Kept
+     * if they fit in the free budget, or if the query is more frequent
+     * than every entry that would have to make room for it.
+     */
+    void insert(const std::string& key, uint64_t generation, const std::vector<Result>& results) {
+        Entry e;
+        e.key = key;
+        e.hash = std::hash<std::string>{}(key);
+        e.generation = generation;
+        e.docIDs.reserve(results.size());
+        e.scores.reserve(results.size());
+        for (const Result& r : results) {
+            e.docIDs.push_back(static_cast<uint32_t>(r.docID));
+            e.scores.push_back(r.score);
+        }
+        e.bytes = sizeof(Entry) + 2 * key.size() + 64 + // the map keeps a key copy and a node
+                  e.docIDs.capacity() * sizeof(uint32_t) + e.scores.capacity() * sizeof(Score);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto old = index_.find(key);
+        if (old != index_.end()) erase(old->second);
+
+        if (e.bytes > stats_.budget || !makeRoom(e.bytes, sketch_.estimate(e.hash))) {
+            stats_.rejections++;
+            return;
+        }
+
+        stats_.bytes += e.bytes;
+        stats_.admissions++;
+        lru_.push_front(std::move(e));
+        index_[lru_.front().key] = lru_.begin();
+    }
+
+    void setBudget(size_t budgetBytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.budget = budgetBytes;
+        while (stats_.bytes > stats_.budget && !lru_.empty()) evict();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lru_.clear();
+        index_.clear();
+        sketch_.clear();
+        stats_.bytes = 0;
+    }
+
+    ResultCacheStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ResultCacheStats s = stats_;
+        s.entries = index_.size();
+        return s;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        size_t hash;
+        uint64_t generation;
+        std::vector<uint32_t> docIDs;
+        std::vector<Score> scores;
+        size_t bytes;
+    };
+    using Iterator = typename std::list<Entry>::iterator;
+
+    // Frees `bytes` from the LRU end unless a victim is at least as
+    // frequent as the newcomer; then nothing is evicted
+    bool makeRoom(size_t bytes, uint8_t frequency) {
+        size_t freed = stats_.budget - stats_.bytes;
+        size_t victims = 0;
+        for (auto it = lru_.rbegin(); freed < bytes && it != lru_.rend(); ++it, ++victims) {
+            if (sketch_.estimate(it->hash) >= frequency) return false;
+            freed += it->bytes;
+        }
+        while (victims-- > 0) evict();
+        return true;
+    }
+
+    void evict() {
+        erase(std::prev(lru_.end()));
+        stats_.evictions++;
+    }
+
+    void erase(Iterator it) {
+        stats_.bytes -= it->bytes;
+        index_.erase(it->key);
+        lru_.erase(it);
+    }
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, Iterator> index_;
+    FrequencySketch sketch_;
+    ResultCacheStats stats_;
+};
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include "MappedFile.hpp"
+
+// =================================================================
+// IMMUTABLE TERM DICTIONARY (minimal perfect hash over a string pool)
+// =================================================================
+//
+// Replaces unordered_map<string,int>: one contiguous image that can be
+// written to disk and mapped back without parsing. Layout (uint32 words):
+//
+//   DictHeader
+//   uint32 seeds[bucketCount]          per-bucket displacement seed
+//   uint32 slots[termCount]            MPH slot -> sorted ordinal
+//   uint32 stringOffsets[termCount+1]  into the pool
+//   uint32 lexIDs[termCount]           by sorted ordinal
+//   char   pool[]                      terms, sorted bytewise
+//
+// lookup(): hash -> bucket -> seed -> slot -> ordinal, then one string
+// compare to reject words that are not in the dictionary: O(|term|).
+// The sorted pool gives ordered prefix iteration for autocomplete.
+
+const char DICT_MAGIC[4] = {'L', 'U', 'M', 'D'};
+const uint32_t DICT_VERSION = 1;
+
+struct DictHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t termCount;
+    uint32_t bucketCount;
+    uint32_t poolSize;
+    uint32_t reserved;
+};
+
+inline uint64_t dictHash(std::string_view s, uint64_t seed) {
+    uint64_t h = 1469598103934665603ull ^ (seed * 0x9E3779B97F4A7C15ull);
+    for (char c : s) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 1099511628211ull;
+    }
+    // murmur3 finalizer, so nearby seeds give unrelated slots
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+class TermDictionary {
+public:
+    TermDictionary() = default;
+    TermDictionary(const TermDictionary&) = delete;
+    TermDictionary& operator=(const TermDictionary&) = delete;
+    TermDictionary(TermDictionary&&) = default;
+    TermDictionary& operator=(TermDictionary&&) = default;
+
+    // -------------------- BUILD --------------------
+    /**
+     * @brief Serializes word -> lexID pairs into a dictionary image.
+     */
+    static std::vector<char> build(std::vector<std::pair<std::string, uint32_t>> terms) {
+        std::sort(terms.begin(), terms.end());
+        terms.erase(std::unique(terms.begin(), terms.end(),
+                                [](const auto& a, const auto& b) { return a.first == b.first; }),
+                    terms.end());
+
+        uint32_t n = static_cast<uint32_t>(terms.size());
+        uint32_t bucketCount = n / 3 + 1;
+
+        // Hash-and-displace: place the biggest buckets first, searching for
+        // a seed that sends every key of the bucket to a distinct free slot.
+        std::vector<std::vector<uint32_t>> buckets(bucketCount);
+        for (uint32_t i = 0; i < n; ++i)
+            buckets[dictHash(terms[i].first, 0) % bucketCount].push_back(i);
+
+        std::vector<uint32_t> order(bucketCount);
+        for (uint32_t b = 0; b < bucketCount; ++b) order[b] = b;
+        std::sort(order.begin(), order.end(),
+                  [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        std::vector<uint32_t> seeds(bucketCount, 0);
+        std::vector<uint32_t> slots(n, 0);
+        std::vector<bool> taken(n, false);
+        std::vector<uint32_t> tried;
+
+        for (uint32_t b : order) {
+            if (buckets[b].empty()) break;
+            for (uint32_t seed = 1;; ++seed) {
+                tried.clear();
+                bool ok = true;
+                for (uint32_t i : buckets[b]) {
+                    uint32_t slot = static_cast<uint32_t>(dictHash(terms[i].first, seed) % n);
+                    if (taken[slot] || std::find(tried.begin(), tried.end(), slot) != tried.end()) {
+                        ok = false;
+                        break;
+                    }
+                    tried.push_back(slot);
+                }
+                if (!ok) continue;
+
+                seeds[b] = seed;
+                for (size_t k = 0; k < tried.size(); ++k) {
+                    taken[tried[k]] = true;
+                    slots[tried[k]] = buckets[b][k];
+                }
+                break;
+            }
+        }
+
+        DictHeader header{};
+        std::memcpy(header.magic, DICT_MAGIC, 4);
+        header.version = DICT_VERSION;
+        header.termCount = n;
+        header.bucketCount = bucketCount;
+
+        std::vector<uint32_t> offsets, lexIDs;
+        offsets.reserve(n + 1);
+        lexIDs.reserve(n);
+        uint32_t pool = 0;
+        for (const auto& [word, id] : terms) {
+            offsets.push_back(pool);
+            lexIDs.push_back(id);
+            pool += static_cast<uint32_t>(word.size());
+        }
+        offsets.push_back(pool);
+        header.poolSize = pool;
+
+        std::vector<char> image;
+        auto append = [&](const void* p, size_t bytes) {
+            const char* c = static_cast<const char*>(p);
+            image.insert(image.end(), c, c + bytes);
+        };
+        append(&header, sizeof(header));
+        append(seeds.data(), seeds.size() * sizeof(uint32_t));
+        append(slots.data(), slots.size() * sizeof(uint32_t));
+        append(offsets.data(), offsets.size() * sizeof(uint32_t));
+        append(lexIDs.data(), lexIDs.size() * sizeof(uint32_t));
+        for (const auto& [word, id] : terms) append(word.data(), word.size());
+        image.resize((image.size() + 7) & ~size_t(7));
+        return image;
+    }
+
+    static std::vector<char> build(const std::unordered_map<std::string, int>& lex) {
+        std::vector<std::pair<std::string, uint32_t>> terms;
+        terms.reserve(lex.size());
+        for (const auto& [word, id] : lex) terms.emplace_back(word, static_cast<uint32_t>(id));
+        return build(std::move(terms));
+    }
+
+    static bool save(const std::string& path, const std::vector<char>& image) {
+        std::ofstream fout(path, std::ios::binary);
+        if (!fout) {
+            std::cerr << "ERROR: Cannot write dictionary " << path << "\n";
+            return false;
+        }
+        fout.write(image.data(), image.size());
+        return static_cast<bool>(fout);
+    }
+
+    // -------------------- OPEN --------------------
+    // Takes ownership of an image produced by build().
+    bool assign(std::vector<char> image) {
+        file_.close();
+        owned_ = std::move(image);
+        return attach(owned_.data(), owned_.size());
+    }
+
+    // Maps a saved dictionary file.
+    bool open(const std::string& path) {
+        owned_.clear();
+        if (!file_.open(path)) return false;
+        return attach(file_.data(), file_.size());
+    }
+
+    /**
+     * @brief Views an image owned elsewhere (e.g. inside a mapped segment).
+     * The memory must stay valid and 4-byte aligned while in use.
+     */
+    bool attach(const char* data, size_t size) {
+        header_ = nullptr;
+        if (size < sizeof(DictHeader)) return false;
+
+        const auto* header = reinterpret_cast<const DictHeader*>(data);
+        if (std::memcmp(header->magic, DICT_MAGIC, 4) != 0 || header->version != DICT_VERSION) {
+            std::cerr << "ERROR: Invalid term dictionary image\n";
+            return false;
+        }
+        size_t words = header->bucketCount + 3 * static_cast<size_t>(header->termCount) + 1;
+        if (sizeof(DictHeader) + words * sizeof(uint32_t) + header->poolSize > size) {
+            std::cerr << "ERROR: Truncated term dictionary image\n";
+            return false;
+        }
+
+        header_  = header;
+        seeds_   = reinterpret_cast<const uint32_t*>(data + sizeof(DictHeader));
+        slots_   = seeds_ + header->bucketCount;
+        offsets_ = slots_ + header->termCount;
+        lexIDs_  = offsets_ + header->termCount + 1;
+        pool_    = reinterpret_cast<const char*>(lexIDs_ + header->termCount);
+        return true;
+    }
+
+    // -------------------- QUERY --------------------
+    bool empty() const { return !header_ || header_->termCount == 0; }
+    uint32_t size() const { return header_ ? header_->termCount : 0; }
+
+    // i-th term in sorted order
+    std::string_view term(uint32_t i) const {
+        return std::string_view(pool_ + offsets_[i], offsets_[i + 1] - offsets_[i]);
+    }
+    uint32_t lexID(uint32_t i) const { return lexIDs_[i]; }
+
+    /**
+     * @brief Sorted ordinal of word, or -1 if it is not in the dictionary.
+     */
+    int64_t find(std::string_view word) const {
+        if (empty()) return -1;
+        uint32_t bucket = static_cast<uint32_t>(dictHash(word, 0) % header_->bucketCount);
+        uint32_t slot = static_cast<uint32_t>(dictHash(word, seeds_[bucket]) % header_->termCount);
+        uint32_t ord = slots_[slot];
+        return term(ord) == word ? static_cast<int64_t>(ord) : -1;
+    }
+
+    /**
+     * @brief lexID of word, or -1 if it is not in the dictionary.
+     */
+    int lookup(std::string_view word) const {
+        int64_t ord = find(word);
+        return ord < 0 ? -1 : static_cast<int>(lexIDs_[ord]);
+    }
+
+    bool contains(std::string_view word) const { return find(word) >= 0; }
+
+    /**
+     * @brief [first, last) sorted ordinals of the terms starting with prefix.
+     */
+    std::pair<uint32_t, uint32_t> prefixRange(std::string_view prefix) const {
+        uint32_t first = lowerBound(prefix), last = first;
+        while (last < size() && term(last).substr(0, prefix.size()) == prefix) ++last;
+        return {first, last};
+    }
+
+    /**
+     * @brief Up to limit terms starting with prefix, in alphabetical order.
+     */
+    std::vector<std::string> complete(std::string_view prefix, size_t limit) const {
+        std::vector<std::string> out;
+        for (uint32_t i = lowerBound(prefix); i < size() && out.size() < limit; ++i) {
+            std::string_view t = term(i);
+            if (t.substr(0, prefix.size()) != prefix) break;
+            out.emplace_back(t);
+        }
+        return out;
+    }
+
+    // Bytes used by the image (the mapping or the owned buffer).
+    size_t bytes() const {
+        if (!header_) return 0;
+        return sizeof(DictHeader) +
+               (header_->bucketCount + 3 * static_cast<size_t>(header_->termCount) + 1) * sizeof(uint32_t) +
+               header_->poolSize;
+    }
+
+private:
+    // first sorted ordinal whose term is >= key
+    uint32_t lowerBound(std::string_view key) const {
+        uint32_t lo = 0, hi = size();
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (term(mid) < key) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    std::vector<char> owned_;
+    MappedFile file_;
+    const DictHeader* header_ = nullptr;
+    const uint32_t* seeds_ = nullptr;
+    const uint32_t* slots_ = nullptr;
+    const uint32_t* offsets_ = nullptr;
+    const uint32_t* lexIDs_ = nullptr;
+    const char* pool_ = nullptr;
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include "MappedFile.hpp"
+
+// =================================================================
+// DENSE PER-TERM STATISTICS (term_stats.bin)
+// =================================================================
+//
+// LexIDs are dense, so barrel and DF live in flat arrays indexed by
+// lexID instead of unordered_map<int,int>. Layout:
+//
+//   TermStatsHeader
+//   uint8  barrel[count]   NO_BARREL if the term is in no barrel
+//   (padding to 4 bytes)
+//   uint32 df[count]       0 if the term has no DF entry
+//
+// IDFs are not stored: BM25 (BM25.hpp) derives them from these DFs and
+// the N it is configured with. Version 1 images carried a trailing IDF
+// column of a different formula; they are still read, and it is ignored.
+
+const char     TERM_STATS_MAGIC[4] = {'L', 'U', 'M', 'T'};
+const uint32_t TERM_STATS_VERSION  = 2;
+const uint8_t  NO_BARREL           = 0xFF;
+
+struct TermStatsHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t count;           // maxLexID + 1
+    uint32_t totalDocuments;  // N of the index (BM25's fallback without doc lengths)
+};
+
+class TermStats {
+public:
+    TermStats() = default;
+    TermStats(const TermStats&) = delete;
+    TermStats& operator=(const TermStats&) = delete;
+    TermStats(TermStats&&) = default;
+    TermStats& operator=(TermStats&&) = default;
+
+    // -------------------- BUILD --------------------
+    /**
+     * @brief Serializes the JSON-derived maps into a stats image.
+     * Barrel IDs must fit in a byte (the engine uses 32 barrels).
+     */
+    static std::vector<char> build(const std::unordered_map<int, int>& barrelMap,
+                                   const std::unordered_map<int, int>& df,
+                                   uint32_t totalDocuments)
+    {
+        uint32_t count = 0;
+        for (const auto& [id, b] : barrelMap) if (id >= 0) count = std::max(count, static_cast<uint32_t>(id) + 1);
+        for (const auto& [id, d] : df) if (id >= 0) count = std::max(count, static_cast<uint32_t>(id) + 1);
+
+        TermStatsHeader header{};
+        std::memcpy(header.magic, TERM_STATS_MAGIC, 4);
+        header.version = TERM_STATS_VERSION;
+        header.count = count;
+        header.totalDocuments = totalDocuments;
+
+        size_t dfOffset = align4(sizeof(TermStatsHeader) + count);
+        std::vector<char> image(dfOffset + static_cast<size_t>(count) * sizeof(uint32_t), 0);
+        std::memcpy(image.data(), &header, sizeof(header));
+
+        auto* barrels = reinterpret_cast<uint8_t*>(image.data() + sizeof(TermStatsHeader));
+        auto* dfs     = reinterpret_cast<uint32_t*>(image.data() + dfOffset);
+
+        std::memset(barrels, NO_BARREL, count);
+        for (const auto& [id, b] : barrelMap) {
+            if (id < 0) continue;
+            if (b < 0 || b >= NO_BARREL) {
+                std::cerr << "WARNING: Barrel " << b << " of lexID " << id << " does not fit term stats\n";
+                continue;
+            }
+            barrels[id] = static_cast<uint8_t>(b);
+        }
+        for (const auto& [id, d] : df) {
+            if (id < 0) continue;
+            dfs[id] = static_cast<uint32_t>(d);
+        }
+        return image;
+    }
+
+    static bool save(const std::string& path, const std::vector<char>& image) {
+        std::ofstream fout(path, std::ios::binary);
+        if (!fout) {
+            std::cerr << "ERROR: Cannot write term stats " << path << "\n";
+            return false;
+        }
+        fout.write(image.data(), image.size());
+        return static_cast<bool>(fout);
+    }
+
+    // -------------------- OPEN --------------------
+    bool assign(std::vector<char> image) {
+        file_.close();
+        owned_ = std::move(image);
+        return attach(owned_.data(), owned_.size());
+    }
+
+    bool open(const std::string& path) {
+        owned_.clear();
+        if (!file_.open(path)) return false;
+        return attach(file_.data(), file_.size());
+    }
+
+    // -------------------- QUERY --------------------
+    uint32_t size() const { return count_; }
+    uint32_t totalDocuments() const { return totalDocuments_; }
+
+    // Barrel of lexID, or -1
+    int barrel(int lexID) const {
+        if (!inRange(lexID) || barrels_[lexID] == NO_BARREL) return -1;
+        return barrels_[lexID];
+    }
+
+    uint32_t df(int lexID) const { return inRange(lexID) ? dfs_[lexID] : 0; }
+    bool hasDF(int lexID) const { return df(lexID) != 0; }
+
+    size_t bytes() const {
+        return count_ ? align4(sizeof(TermStatsHeader) + count_) + static_cast<size_t>(count_) * sizeof(uint32_t) : 0;
+    }
+
+private:
+    static size_t align4(size_t n) { return (n + 3) & ~size_t(3); }
+
+    bool inRange(int lexID) const { return lexID >= 0 && static_cast<uint32_t>(lexID) < count_; }
+
+    bool attach(const char* data, size_t size) {
+        count_ = 0;
+        if (size < sizeof(TermStatsHeader)) return false;
+
+        const auto* header = reinterpret_cast<const TermStatsHeader*>(data);
+        if (std::memcmp(header->magic, TERM_STATS_MAGIC, 4) != 0 ||
+            (header->version != TERM_STATS_VERSION && header->version != 1)) {
+            std::cerr << "ERROR: Invalid term stats image\n";
+            return false;
+        }
+        size_t dfOffset = align4(sizeof(TermStatsHeader) + header->count);
+        if (dfOffset + static_cast<size_t>(header->count) * sizeof(uint32_t) > size) {
+            std::cerr << "ERROR: Truncated term stats image\n";
+            return false;
+        }
+
+        count_          = header->count;
+        totalDocuments_ = header->totalDocuments;
+        barrels_        = reinterpret_cast<const uint8_t*>(data + sizeof(TermStatsHeader));
+        dfs_            = reinterpret_cast<const uint32_t*>(data + dfOffset);
+        return true;
+    }
+
+    std::vector<char> owned_;
+    MappedFile file_;
+    uint32_t count_ = 0;
+    uint32_t totalDocuments_ = 0;
+    const uint8_t* barrels_ = nullptr;
+    const uint32_t* dfs_ = nullptr;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+
+// =================================================================
+// TOP-K SELECTION
+// =================================================================
+//
+// Keeps the k best results seen so far in a fixed-size min-heap, so
+// ranking n candidates costs O(n log k) instead of sorting all n. The
+// worst kept score is the admission threshold: once the heap is full, a
+// candidate that does not beat it is rejected with one comparison, which
+// is the common case for broad queries.
+//
+// Result is any struct with docID and score members (the SearchResult of
+// Scoring.hpp or of new_Semantic.cpp). Ties on score go to the lower
+// docID, so the selected set does not depend on candidate order. The heap
+// lives in the given memory resource (the query arena, QueryScratch.hpp),
+// so only the returned results are allocated from the heap.
+
+template <typename Result>
+class TopK {
+public:
+    explicit TopK(size_t k, std::pmr::memory_resource* mem = std::pmr::get_default_resource())
+        : k_(k), heap_(mem)
+    {
+        heap_.reserve(std::min<size_t>(k, 1024));
+    }
+
+    size_t k() const { return k_; }
+    size_t size() const { return heap_.size(); }
+    bool full() const { return heap_.size() >= k_; }
+
+    // Score a candidate must beat once the heap is full
+    decltype(Result::score) threshold() const { return heap_.front().score; }
+
+    // True if r would be admitted right now
+    bool accepts(const Result& r) const {
+        return k_ > 0 && (!full() || better(r, heap_.front()));
+    }
+
+    void push(const Result& r) {
+        if (!accepts(r)) return;
+        if (full()) {
+            std::pop_heap(heap_.begin(), heap_.end(), better);
+            heap_.back() = r;
+        } else {
+            heap_.push_back(r);
+        }
+        std::push_heap(heap_.begin(), heap_.end(), better);
+    }
+
+    // Best first; empties the selector
+    std::vector<Result> take() {
+        std::sort_heap(heap_.begin(), heap_.end(), better);
+        std::vector<Result> out(heap_.begin(), heap_.end());
+        heap_.clear();
+        return out;
+    }
+
+    // Orders best first; as a heap comparator it keeps the worst on top
+    static bool better(const Result& a, const Result& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.docID < b.docID;
+    }
+
+private:
+    size_t k_;
+    std::pmr::vector<Result> heap_;
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+#include "PostingCursor.hpp"
+#include "TopK.hpp"
+#include "BM25.hpp"
+
+// =================================================================
+// RANKED OR: WAND / BLOCK-MAX WAND
+// =================================================================
+//
+// Top-k over documents that contain *any* query term, without scoring
+// every posting. Each term has an upper bound on what it can add to a
+// document (its scorer's bound at the list's max freq). The cursors are
+// kept sorted by docID; walking them in that order and summing bounds
+// until the sum beats the heap threshold finds the "pivot": no document
+// before the pivot's docID can enter the top k, so the earlier cursors
+// jump straight to it.
+//
+// Block-Max WAND additionally checks the per-block bounds of the cursors
+// up to the pivot (PostingCursor::blockMaxFreq, read from block headers
+// without decoding). If even those cannot beat the threshold, everything
+// up to the end of the shallowest block is skipped.
+//
+// Scores are additive over matched terms: score(d) = sum of
+// scorer.score(freq, d) for every term present in d. Results are exactly
+// those of scoring every document (see scoreExhaustive).
+//
+// The evaluators' working arrays and top-k heap are allocated from the
+// memory resource of the cursor list (the query arena, QueryScratch.hpp).
+
+// Contribution of one term occurrence list to a document's score: its
+// BM25 share plus a fixed bonus per matched term
+struct TermScorer {
+    const BM25* model = nullptr;
+    float idf   = 0.0f;
+    float bonus = 0.0f;
+
+    float score(uint32_t freq, uint32_t docID) const { return model->termScore(idf, freq, docID) + bonus; }
+
+    // Bound on score(f, d) for f <= maxFreq over every d, widened so float
+    // rounding in a different summation order can never prune a document
+    // that belongs in the top k
+    float bound(uint32_t maxFreq) const {
+        float s = model->termBound(idf, maxFreq) + bonus;
+        return s + std::fabs(s) * 1e-4f;
+    }
+};
+
+struct ScoredCursor {
+    PostingCursor* cursor;
+    TermScorer scorer;
+    float maxScore;     // scorer.bound() over the whole list
+
+    // Block-Max WAND: bound of the block ending at blockEnd, refreshed
+    // only once the pivot moves past it
+    float blockScore = 0.0f;
+    uint32_t blockEnd = 0;
+    bool hasBlock = false;
+
+    float blockBound(uint32_t target) {
+        if (!hasBlock || target > blockEnd) {
+            blockScore = scorer.bound(cursor->blockMaxFreq(target, blockEnd));
+            hasBlock = true;
+        }
+        return blockScore;
+    }
+};
+
+/**
+ * @brief Pairs every non-empty cursor with its scorer and list bound.
+ */
+inline std::pmr::vector<ScoredCursor> scoredCursors(std::pmr::vector<PostingCursor>& cursors,
+                                                    const std::pmr::vector<TermScorer>& scorers)
+{
+    std::pmr::vector<ScoredCursor> terms(cursors.get_allocator());
+    terms.reserve(cursors.size());
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        if (cursors[i].atEnd()) continue;
+        terms.push_back({&cursors[i], scorers[i], scorers[i].bound(cursors[i].maxFreq())});
+    }
+    return terms;
+}
+
+inline uint32_t docOrEnd(const ScoredCursor& t) {
+    return t.cursor->atEnd() ? std::numeric_limits<uint32_t>::max() : t.cursor->docID();
+}
+
+// Score of doc from every term positioned on it, summed in term order
+inline float scoreAt(const std::pmr::vector<ScoredCursor>& terms, uint32_t doc) {
+    float score = 0.0f;
+    for (const ScoredCursor& t : terms)
+        if (!t.cursor->atEnd() && t.cursor->docID() == doc)
+            score += t.scorer.score(t.cursor->freq(), doc);
+    return score;
+}
+
+/**
+ * @brief Best k documents containing any term, WAND or (blockMax) BMW.
+ * cursors[i] is scored with scorers[i]; cursors are consumed. Only docIDs
+ * below endDoc are ranked (one range of a partitioned query).
+ */
+template <typename Result>
+std::vector<Result> wandSearch(std::pmr::vector<PostingCursor>& cursors,
+                               const std::pmr::vector<TermScorer>& scorers,
+                               size_t k, bool blockMax,
+                               uint32_t endDoc = std::numeric_limits<uint32_t>::max())
+{
+    std::pmr::memory_resource* mem = cursors.get_allocator().resource();
+    TopK<Result> top(k, mem);
+    std::pmr::vector<ScoredCursor> terms = scoredCursors(cursors, scorers);
+    if (k == 0) return top.take();
+
+    std::pmr::vector<ScoredCursor*> live(mem);
+    live.reserve(terms.size());
+    for (auto& t : terms) live.push_back(&t);
+
+    const uint32_t NO_DOC = std::numeric_limits<uint32_t>::max();
+
+    for (;;) {
+        // Only the cursors that moved are out of place: insertion-sort them
+        // back, dropping exhausted ones (they sort last as NO_DOC)
+        for (size_t i = 1; i < live.size(); ++i) {
+            ScoredCursor* t = live[i];
+            uint32_t doc = docOrEnd(*t);
+            size_t j = i;
+            for (; j > 0 && docOrEnd(*live[j - 1]) > doc; --j) live[j] = live[j - 1];
+            live[j] = t;
+        }
+        while (!live.empty() && live.back()->cursor->atEnd()) live.pop_back();
+        if (live.empty()) break;
+
+        // Pivot: first cursor at which the summed bounds can beat the threshold
+        float threshold = top.full() ? static_cast<float>(top.threshold())
+                                     : -std::numeric_limits<float>::infinity();
+        float bound = 0.0f;
+        size_t p = 0;
+        for (; p < live.size(); ++p) {
+            bound += live[p]->maxScore;
+            if (bound > threshold) break;
+        }
+        if (p == live.size()) break; // nothing left can enter the top k
+
+        uint32_t pivotDoc = live[p]->cursor->docID();
+        if (pivotDoc >= endDoc) break; // no doc before the pivot can make it
+        while (p + 1 < live.size() && live[p + 1]->cursor->docID() == pivotDoc) ++p;
+
+        if (blockMax && top.full()) {
+            float blockBound = 0.0f;
+            uint32_t blockEnd = NO_DOC;
+            for (size_t i = 0; i <= p; ++i) {
+                blockBound += live[i]->blockBound(pivotDoc);
+                blockEnd = std::min(blockEnd, live[i]->blockEnd);
+            }
+            if (blockBound <= threshold) {
+                // No doc up to the end of the shallowest block can make it
+                uint32_t target = (blockEnd == NO_DOC) ? NO_DOC : blockEnd + 1;
+                if (p + 1 < live.size()) target = std::min(target, live[p + 1]->cursor->docID());
+                target = std::max(target, pivotDoc + 1);
+                for (size_t i = 0; i <= p; ++i) {
+                    PostingCursor& c = *live[i]->cursor;
+                    c.advance(target);
+                    if (target == NO_DOC && !c.atEnd()) c.next(); // exhaust the list
+                }
+                continue;
+            }
+        }
+
+        if (live[0]->cursor->docID() == pivotDoc) {
+            // Every cursor up to p sits on the pivot: score it for real
+            top.push({static_cast<int>(pivotDoc), scoreAt(terms, pivotDoc)});
+            for (size_t i = 0; i <= p; ++i) live[i]->cursor->next();
+        } else {
+            // Nothing before the pivot can make it; jump the earlier cursors there
+            for (size_t i = 0; i < p && live[i]->cursor->docID() < pivotDoc; ++i)
+                live[i]->cursor->advance(pivotDoc);
+        }
+    }
+    return top.take();
+}
+
+/**
+ * @brief Reference evaluator: scores every document of every list.
+ * Same results as wandSearch(); used to check and benchmark it.
+ */
+template <typename Result>
+std::vector<Result> scoreExhaustive(std::pmr::vector<PostingCursor>& cursors,
+                                    const std::pmr::vector<TermScorer>& scorers,
+                                    size_t k)
+{
+    TopK<Result> top(k, cursors.get_allocator().resource());
+    std::pmr::vector<ScoredCursor> terms = scoredCursors(cursors, scorers);
+
+    for (;;) {
+        uint32_t doc = std::numeric_limits<uint32_t>::max();
+        bool any = false;
+        for (auto& t : terms)
+            if (!t.cursor->atEnd()) { doc = std::min(doc, t.cursor->docID()); any = true; }
+        if (!any) break;
+
+        top.push({static_cast<int>(doc), scoreAt(terms, doc)});
+        for (auto& t : terms)
+            if (!t.cursor->atEnd() && t.cursor->docID() == doc) t.cursor->next();
+    }
+    return top.take();
+}
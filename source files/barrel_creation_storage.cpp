@@ -4,7 +4,9 @@
 #include <vector>
 #include <string>
 #include <filesystem>
+#include <algorithm>
 #include "nlohmann/json.hpp"
+#include "JsonScanner.hpp"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
@@ -12,66 +14,91 @@ namespace fs = std::filesystem;
 // -------------------- Load Barrel Mapping --------------------
 std::unordered_map<int,int> loadBarrelMapping(const std::string& mapFile)
 {
-    std::ifstream fin(mapFile);
-    if(!fin){
+    JsonFile file;
+    if(!file.open(mapFile)){
         std::cerr << "ERROR: Cannot open barrel mapping file\n";
         exit(1);
     }
 
-    json mapJson;
-    fin >> mapJson;
-    fin.close();
-
     std::unordered_map<int,int> barrelMap;
 
-    for(auto& [lexID, barrelID] : mapJson.items())
-        barrelMap[std::stoi(lexID)] = barrelID;
+    JsonCursor cur = file.cursor();
+    cur.object([&](std::string_view lexID, JsonCursor& barrelID) {
+        int id;
+        if(parseKey(lexID, id)) barrelMap[id] = static_cast<int>(barrelID.integer());
+        else barrelID.skip();
+    });
+
+    if(!cur.ok()){
+        std::cerr << "ERROR: Malformed barrel mapping file\n";
+        exit(1);
+    }
 
     return barrelMap;
 }
 
 
 // -------------------- Load Inverted Index --------------------
-json loadInvertedIndex(const std::string& invFile)
+// The posting lists are only copied from the index into the barrels, so
+// they are kept as raw JSON text (views into the mapped file) instead of
+// being parsed into a DOM.
+struct InvertedIndexText {
+    JsonFile file;
+    std::vector<std::pair<std::string_view, std::string_view>> terms; // lexID key -> posting list text
+
+    size_t size() const { return terms.size(); }
+};
+
+InvertedIndexText loadInvertedIndex(const std::string& invFile)
 {
-    std::ifstream fin(invFile);
+    InvertedIndexText index;
 
-    if(!fin){
+    if(!index.file.open(invFile)){
         std::cerr << "ERROR: Cannot open inverted index file\n";
         exit(1);
     }
 
-    json invJson;
-    fin >> invJson;
-    fin.close();
+    // Keys in this file never contain escapes, so their views point into the mapping
+    JsonCursor cur = index.file.cursor();
+    cur.object([&](std::string_view lexIDstr, JsonCursor& docList) {
+        index.terms.emplace_back(lexIDstr, docList.raw());
+    });
 
-    return invJson;
+    if(!cur.ok()){
+        std::cerr << "ERROR: Malformed inverted index file\n";
+        exit(1);
+    }
+
+    return index;
 }
 
 
 // -------------------- Create Barrel Files --------------------
 void buildBarrels(
-    const json& invertedIndex,
+    const InvertedIndexText& invertedIndex,
     const std::unordered_map<int,int>& barrelMap,
     const std::string& outDir)
 {
     fs::create_directories(outDir);
 
-    std::vector<json> barrels(32);   // 32 total barrels
+    // 32 total barrels, each a list of (lexID key, posting list text)
+    std::vector<std::vector<std::pair<std::string_view, std::string_view>>> barrels(32);
 
     // Iterate through inverted index
-    for(auto& [lexIDstr, docList] : invertedIndex.items())
+    for(auto& [lexIDstr, docList] : invertedIndex.terms)
     {
-        int lexID = std::stoi(lexIDstr);
+        int lexID;
+        if(!parseKey(lexIDstr, lexID))
+            continue;
 
         auto it = barrelMap.find(lexID);
-        if(it == barrelMap.end())
+        if(it == barrelMap.end() || it->second < 0 || it->second >= 32)
             continue;
 
         int barrelID = it->second;
 
         // Store word's posting list inside its barrel
-        barrels[barrelID][lexIDstr] = docList;
+        barrels[barrelID].emplace_back(lexIDstr, docList);
     }
 
     // Save barrel files
@@ -87,7 +114,13 @@ void buildBarrels(
             continue;
         }
 
-        fout << barrels[i].dump(4);
+        // Same key order nlohmann's json object would write
+        std::sort(barrels[i].begin(), barrels[i].end());
+
+        fout << "{";
+        for(size_t t = 0; t < barrels[i].size(); ++t)
+            fout << (t ? ",\n" : "\n") << "    \"" << barrels[i][t].first << "\": " << barrels[i][t].second;
+        fout << (barrels[i].empty() ? "}" : "\n}");
         fout.close();
 
         std::cout << "✓ Barrel " << i
@@ -114,7 +147,7 @@ void buildBarrels(
 //     std::string outputDir   = argv[3];
 
 //     // Load data
-//     json invertedIndex = loadInvertedIndex(invertedFile);
+//     auto invertedIndex = loadInvertedIndex(invertedFile);
 //     auto barrelMap     = loadBarrelMapping(mapFile);
 
 //     std::cout << "Loaded inverted index: "
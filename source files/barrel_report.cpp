@@ -0,0 +1,120 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include "nlohmann/json.hpp"
+#include "BinaryBarrel.hpp"
+
+using json = nlohmann::json;
+using Clock = std::chrono::high_resolution_clock;
+
+// Size / decode-speed comparison of the JSON barrels against the raw,
+// VByte and bit-packed block binary encodings. Everything is built in
+// memory, so the barrels directory is left untouched.
+
+struct FormatStats {
+    size_t bytes = 0;
+    double decodeMs = 0.0;
+};
+
+double elapsedMs(Clock::time_point t1, Clock::time_point t2) {
+    return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// Decodes every term of an in-memory barrel image once; returns checksum.
+uint64_t decodeAll(const std::vector<char>& image, BarrelPostings& scratch) {
+    const auto* header = reinterpret_cast<const BarrelHeader*>(image.data());
+    const auto* table  = reinterpret_cast<const BarrelTermEntry*>(image.data() + sizeof(BarrelHeader));
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < header->termCount; ++i) {
+        decodeBarrelBlock(header->version, image.data() + table[i].offset,
+                          barrelBlockSize(*header, table, i, image.size()), table[i].length, scratch);
+        for (uint32_t d : scratch.docIDs) sum += d;
+    }
+    return sum;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cout << "Usage: barrel_report <barrels_dir> [total_barrels=32] [repeats=20]\n";
+        return 1;
+    }
+
+    std::string barrelsDir = argv[1];
+    int totalBarrels = (argc > 2) ? std::stoi(argv[2]) : 32;
+    int repeats      = (argc > 3) ? std::stoi(argv[3]) : 20;
+
+    FormatStats jsonStats, rawStats, vbyteStats, blockStats;
+    size_t postings = 0;
+    uint64_t checksum = 0;
+    BarrelPostings scratch;
+
+    for (int b = 0; b < totalBarrels; ++b) {
+        std::ifstream fin(barrelsDir + "/barrel_" + std::to_string(b) + ".json");
+        if (!fin) continue;
+        std::stringstream buf;
+        buf << fin.rdbuf();
+        std::string text = buf.str();
+
+        // JSON: what loadBarrel() does on every lookup today
+        auto t1 = Clock::now();
+        json barrel;
+        for (int r = 0; r < repeats; ++r) barrel = json::parse(text);
+        auto t2 = Clock::now();
+        jsonStats.bytes += text.size();
+        jsonStats.decodeMs += elapsedMs(t1, t2) / repeats;
+
+        std::vector<std::pair<uint32_t, BarrelPostings>> terms;
+        for (auto& [lexID_str, docList] : barrel.items()) {
+            BarrelPostings p;
+            for (auto& [docID_str, freq] : docList.items()) {
+                p.docIDs.push_back(static_cast<uint32_t>(std::stoul(docID_str)));
+                p.freqs.push_back(freq.is_array() ? static_cast<uint32_t>(freq.size())
+                                                  : freq.get<uint32_t>());
+            }
+            postings += p.docIDs.size();
+            terms.emplace_back(static_cast<uint32_t>(std::stoul(lexID_str)), std::move(p));
+        }
+
+        for (auto [version, stats] : {std::make_pair(BARREL_VERSION_RAW, &rawStats),
+                                      std::make_pair(BARREL_VERSION_VBYTE, &vbyteStats),
+                                      std::make_pair(BARREL_VERSION_BLOCK, &blockStats)})
+        {
+            std::vector<char> image = serializeBinaryBarrel(terms, version);
+            auto d1 = Clock::now();
+            for (int r = 0; r < repeats; ++r) checksum += decodeAll(image, scratch);
+            auto d2 = Clock::now();
+            stats->bytes += image.size();
+            stats->decodeMs += elapsedMs(d1, d2) / repeats;
+        }
+    }
+
+    if (postings == 0) {
+        std::cerr << "ERROR: No barrels found in " << barrelsDir << "\n";
+        return 1;
+    }
+
+    auto row = [&](const char* name, const FormatStats& s) {
+        std::cout << std::left << std::setw(8) << name << std::right
+                  << std::setw(12) << s.bytes
+                  << std::setw(10) << std::fixed << std::setprecision(2)
+                  << (double)s.bytes / postings
+                  << std::setw(9) << (double)jsonStats.bytes / s.bytes << "x"
+                  << std::setw(12) << std::setprecision(3) << s.decodeMs
+                  << std::setw(12) << std::setprecision(1) << postings / (s.decodeMs * 1000.0)
+                  << "\n";
+    };
+
+    std::cout << "Postings: " << postings << " (checksum " << checksum << ")\n\n";
+    std::cout << "format         bytes  B/posting  smaller     full ms  Mpost/s\n";
+    row("json", jsonStats);
+    row("raw", rawStats);
+    row("vbyte", vbyteStats);
+    row("block", blockStats);
+    return 0;
+}
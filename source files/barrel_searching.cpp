@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include <string>
 #include "nlohmann/json.hpp"
+#include "BarrelSidecar.hpp"
 #include <chrono> // Required for timing
 
 using json = nlohmann::json;
@@ -97,19 +98,31 @@ void searchWord(
     std::cout << " - LexID: " << lexID << "\n";
     std::cout << " - Barrel: " << barrelID << "\n";
 
-    // STEP 3: load only that barrel
-    json barrel = loadBarrel(barrelsDir, barrelID);
-
-    // STEP 4: find posting list
-    std::string lexIDstr = std::to_string(lexID);
-
-    if (!barrel.contains(lexIDstr)) {
-        std::cout << "Word exists in lexicon but has no postings.\n";
-        return;
+    // STEP 3 + 4: find posting list. The sidecar (barrel_N.idx) points at
+    // just this word's bytes; without one, load the whole barrel.
+    json postingList;
+    std::string slice;
+    std::string barrelPath = barrelsDir + "/barrel_" + std::to_string(barrelID) + ".json";
+
+    if (readBarrelSlice(barrelPath, barrelSidecarPath(barrelsDir, barrelID), lexID, slice)) {
+        if (slice.empty()) {
+            std::cout << "Word exists in lexicon but has no postings.\n";
+            return;
+        }
+        postingList = json::parse(slice);
+    } else {
+        json barrel = loadBarrel(barrelsDir, barrelID);
+
+        std::string lexIDstr = std::to_string(lexID);
+
+        if (!barrel.contains(lexIDstr)) {
+            std::cout << "Word exists in lexicon but has no postings.\n";
+            return;
+        }
+
+        postingList = barrel[lexIDstr];
     }
 
-    json postingList = barrel[lexIDstr];
-
     std::cout << "\n=== RESULTS ===\n";
     for (auto& [docID, freq] : postingList.items()) {
         std::cout << "Doc " << docID << " (freq: " << freq << ")\n";
@@ -1,54 +1,102 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 
-// 1. Include the Search Logic first (this defines SearchResult and loadLexicon)
-#include "new_Semantic.cpp" 
-
-// 2. Include the Autocomplete Logic second
-#include "auto_complete.cpp" 
+// The engine (and the search logic it pulls in from new_Semantic.cpp)
+#include "LumiEngine.hpp"
 
 namespace py = pybind11;
 
-// The Engine class now uses logic from BOTH files
-class LumiEngine {
-public:
-    std::unordered_map<std::string, int> lex;
-    std::unordered_map<int, int> barrelMap;
-    DFMap df;
-    std::string barrelDir;
-    AutocompleteEngine trie; // From auto_complete.cpp
-
-    LumiEngine(std::string lexPath, std::string mapPath, std::string dfPath, std::string bDir) 
-        : barrelDir(bDir) {
-        
-        lex = loadLexicon(lexPath); // From new_Semantic.cpp
-        barrelMap = loadBarrelMap(mapPath);
-        df = loadDFMap(dfPath);
-        
-        for (auto const& [word, id] : lex) {
-            trie.addWordToLexicon(word);
-        }
-    }
-
-    // This calls the function in new_Semantic.cpp
-    std::vector<SearchResult> search(std::string query) {
-        return run_search(query, lex, barrelMap, df, barrelDir);
-    }
-
-    // This calls the method in auto_complete.cpp
-    std::vector<std::string> complete(std::string prefix) {
-        return trie.getSuggestions(prefix, 5);
-    }
-};
+// Hands a vector to numpy without copying; the array owns it
+template <typename T>
+py::array_t<T> toArray(std::vector<T>&& v) {
+    auto* owned = new std::vector<T>(std::move(v));
+    py::capsule release(owned, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return py::array_t<T>(owned->size(), owned->data(), release);
+}
+
 PYBIND11_MODULE(lumi_core, m) {
     py::class_<SearchResult>(m, "SearchResult")
         .def_readwrite("docID", &SearchResult::docID)
         .def_readwrite("score", &SearchResult::score);
 
+    py::enum_<QueryMode>(m, "QueryMode")
+        .value("AND", QueryMode::And)
+        .value("WAND", QueryMode::Wand)
+        .value("BLOCK_MAX_WAND", QueryMode::BlockMaxWand)
+        .value("MAX_SCORE", QueryMode::MaxScore)
+        .value("BOOLEAN", QueryMode::Boolean);
+
+    py::class_<CacheStats>(m, "CacheStats")
+        .def_readonly("hits", &CacheStats::hits)
+        .def_readonly("misses", &CacheStats::misses)
+        .def_readonly("evictions", &CacheStats::evictions)
+        .def_readonly("bytes", &CacheStats::bytes)
+        .def_readonly("budget", &CacheStats::budget)
+        .def_readonly("entries", &CacheStats::entries);
+
+    py::class_<ResultCacheStats>(m, "ResultCacheStats")
+        .def_readonly("hits", &ResultCacheStats::hits)
+        .def_readonly("misses", &ResultCacheStats::misses)
+        .def_readonly("stale", &ResultCacheStats::stale)
+        .def_readonly("admissions", &ResultCacheStats::admissions)
+        .def_readonly("rejections", &ResultCacheStats::rejections)
+        .def_readonly("evictions", &ResultCacheStats::evictions)
+        .def_readonly("bytes", &ResultCacheStats::bytes)
+        .def_readonly("budget", &ResultCacheStats::budget)
+        .def_readonly("entries", &ResultCacheStats::entries)
+        .def_property_readonly("hit_ratio", &ResultCacheStats::hitRatio);
+
+    py::class_<PairCacheStats>(m, "PairCacheStats")
+        .def_readonly("hits", &PairCacheStats::hits)
+        .def_readonly("misses", &PairCacheStats::misses)
+        .def_readonly("materialized", &PairCacheStats::materialized)
+        .def_readonly("rejections", &PairCacheStats::rejections)
+        .def_readonly("evictions", &PairCacheStats::evictions)
+        .def_readonly("bytes", &PairCacheStats::bytes)
+        .def_readonly("budget", &PairCacheStats::budget)
+        .def_readonly("entries", &PairCacheStats::entries);
+
     // Inside PYBIND11_MODULE(lumi_core, m)
+    // Searches and writes release the GIL while in C++: the engine is safe
+    // to search from many Python threads while add_document() runs.
 py::class_<LumiEngine>(m, "LumiEngine")
     .def(py::init<std::string, std::string, std::string, std::string>())
-    .def("search", &LumiEngine::search)
-    .def("complete", &LumiEngine::complete)
-    .def_readwrite("lex", &LumiEngine::lex); // <--- Add this line to allow Python to see 'lex'
+    .def(py::init<std::string>())
+    .def("search", &LumiEngine::search,
+         py::arg("query"), py::arg("k") = DEFAULT_TOP_K, py::arg("mode") = QueryMode::And,
+         py::call_guard<py::gil_scoped_release>())
+    // (offsets, doc_ids, scores): query i's results are doc_ids[offsets[i]:offsets[i + 1]]
+    .def("search_batch",
+         [](LumiEngine& e, const std::vector<std::string>& queries, size_t k, QueryMode mode, unsigned threads) {
+             BatchResults r;
+             {
+                 py::gil_scoped_release release; // the arrays below need it back
+                 r = e.searchBatch(queries, k, mode, threads);
+             }
+             return py::make_tuple(toArray(std::move(r.offsets)), toArray(std::move(r.docIDs)),
+                                   toArray(std::move(r.scores)));
+         },
+         py::arg("queries"), py::arg("k") = DEFAULT_TOP_K, py::arg("mode") = QueryMode::And,
+         py::arg("threads") = 0)
+    .def("set_bm25", &LumiEngine::setBM25, py::arg("k1") = 1.2f, py::arg("b") = 0.75f)
+    .def("set_query_parallelism", &LumiEngine::setQueryParallelism,
+         py::arg("threads") = 0, py::arg("min_postings") = 1u << 18)
+    .def("complete", &LumiEngine::complete, py::call_guard<py::gil_scoped_release>())
+    .def("cache_stats", &LumiEngine::cacheStats)
+    .def("set_cache_budget", &LumiEngine::setCacheBudget)
+    .def("clear_cache", &LumiEngine::clearCache)
+    .def("result_cache_stats", &LumiEngine::resultCacheStats)
+    .def("set_result_cache_budget", &LumiEngine::setResultCacheBudget)
+    .def("clear_result_cache", &LumiEngine::clearResultCache)
+    .def("pair_cache_stats", &LumiEngine::pairCacheStats)
+    .def("set_pair_cache_budget", &LumiEngine::setPairCacheBudget)
+    .def("clear_pair_cache", &LumiEngine::clearPairCache)
+    .def("add_document", &LumiEngine::addDocument, py::arg("doc_id"), py::arg("content"),
+         py::call_guard<py::gil_scoped_release>())
+    .def_property_readonly("generation", &LumiEngine::generation)
+    // Per-word access instead of converting the whole lexicon to a dict
+    .def("lookup", &LumiEngine::lookup)
+    .def("__contains__", [](const LumiEngine& e, const std::string& w) { return e.lookup(w) >= 0; })
+    .def_property_readonly("lexicon_size", &LumiEngine::lexiconSize);
 }
\ No newline at end of file
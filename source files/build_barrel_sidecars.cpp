@@ -0,0 +1,72 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "nlohmann/json.hpp"
+#include "BarrelSidecar.hpp"
+
+using json = nlohmann::json;
+using Clock = std::chrono::high_resolution_clock;
+
+// -------------------- BUILD SIDECARS --------------------
+// Writes barrel_N.idx next to every barrel_N.json (the JSON is not
+// touched), then times one term lookup per barrel through the sidecar
+// against parsing the whole barrel.
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cout << "Usage: build_barrel_sidecars <barrels_dir> [total_barrels=32]\n";
+        return 1;
+    }
+
+    std::string barrelsDir = argv[1];
+    int totalBarrels = (argc > 2) ? std::stoi(argv[2]) : 32;
+
+    int built = 0;
+    double sliceMs = 0.0, fullMs = 0.0;
+    std::string slice;
+
+    for (int b = 0; b < totalBarrels; ++b) {
+        std::string jsonPath = barrelsDir + "/barrel_" + std::to_string(b) + ".json";
+        std::string idxPath = barrelSidecarPath(barrelsDir, b);
+
+        long terms = writeBarrelSidecar(jsonPath, idxPath);
+        if (terms < 0) continue;
+        built++;
+        std::cout << "✓ Barrel " << b << ": " << terms << " terms indexed\n";
+        if (terms == 0) continue;
+
+        // Look up the middle term of the barrel both ways
+        std::ifstream idx(idxPath, std::ios::binary);
+        SidecarHeader header;
+        idx.read(reinterpret_cast<char*>(&header), sizeof(header));
+        SidecarEntry entry;
+        idx.seekg(sizeof(header) + (header.termCount / 2) * sizeof(SidecarEntry));
+        idx.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+
+        auto t1 = Clock::now();
+        readBarrelSlice(jsonPath, idxPath, entry.lexID, slice);
+        json viaSidecar = json::parse(slice);
+        auto t2 = Clock::now();
+        std::ifstream fin(jsonPath);
+        json barrel;
+        fin >> barrel;
+        json viaFull = barrel[std::to_string(entry.lexID)];
+        auto t3 = Clock::now();
+
+        if (viaSidecar != viaFull) {
+            std::cerr << "ERROR: Sidecar slice of lexID " << entry.lexID << " in barrel " << b
+                      << " does not match the barrel\n";
+            return 1;
+        }
+        sliceMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+        fullMs  += std::chrono::duration<double, std::milli>(t3 - t2).count();
+    }
+
+    std::cout << "✅ Indexed " << built << " of " << totalBarrels << " barrels.\n";
+    if (built > 0)
+        std::cout << "One-term lookup: " << sliceMs / built << " ms via sidecar, "
+                  << fullMs / built << " ms parsing the barrel\n";
+    return built > 0 ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "nlohmann/json.hpp"
+#include "BinaryBarrel.hpp"
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+// -------------------- Convert One Barrel --------------------
+// barrel_N.json  { "lexID": { "docID": freq, ... }, ... }  ->  barrel_N.bin
+bool convertBarrel(const std::string& barrelsDir, int barrelID, uint32_t version)
+{
+    std::string jsonPath = barrelsDir + "/barrel_" + std::to_string(barrelID) + ".json";
+    std::ifstream fin(jsonPath);
+    if (!fin) {
+        std::cerr << "Warning: Skipping missing barrel " << jsonPath << "\n";
+        return false;
+    }
+
+    json barrel;
+    try {
+        fin >> barrel;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR parsing " << jsonPath << ": " << e.what() << "\n";
+        return false;
+    }
+    fin.close();
+
+    std::vector<std::pair<uint32_t, BarrelPostings>> terms;
+    terms.reserve(barrel.size());
+
+    for (auto& [lexID_str, docList] : barrel.items()) {
+        try {
+            BarrelPostings p;
+            for (auto& [docID_str, freq] : docList.items()) {
+                p.docIDs.push_back(static_cast<uint32_t>(std::stoul(docID_str)));
+                // Some older barrels store a list of frequencies; count them
+                p.freqs.push_back(freq.is_array() ? static_cast<uint32_t>(freq.size())
+                                                  : freq.get<uint32_t>());
+            }
+            terms.emplace_back(static_cast<uint32_t>(std::stoul(lexID_str)), std::move(p));
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Skipping invalid entry " << lexID_str
+                      << " in barrel " << barrelID << ": " << e.what() << "\n";
+        }
+    }
+
+    size_t termCount = terms.size();
+    std::string binPath = binaryBarrelPath(barrelsDir, barrelID);
+    if (!writeBinaryBarrel(binPath, std::move(terms), version)) return false;
+
+    std::cout << "✓ Barrel " << barrelID << ": " << termCount << " terms, "
+              << fs::file_size(jsonPath) << " -> " << fs::file_size(binPath) << " bytes\n";
+    return true;
+}
+
+// -------------------- MAIN --------------------
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cout << "Usage: build_binary_barrels <barrels_dir> [total_barrels=32] [--vbyte | --block]\n";
+        return 1;
+    }
+
+    std::string barrelsDir = argv[1];
+    int totalBarrels = 32;
+    uint32_t version = BARREL_VERSION_RAW;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--vbyte") version = BARREL_VERSION_VBYTE;
+        else if (arg == "--block") version = BARREL_VERSION_BLOCK;
+        else totalBarrels = std::stoi(arg);
+    }
+
+    int converted = 0;
+    for (int i = 0; i < totalBarrels; ++i)
+        if (convertBarrel(barrelsDir, i, version)) converted++;
+
+    std::cout << "✅ Converted " << converted << " of " << totalBarrels << " barrels ("
+              << (version == BARREL_VERSION_VBYTE ? "vbyte" :
+                  version == BARREL_VERSION_BLOCK ? "block" : "raw") << ").\n";
+    return converted > 0 ? 0 : 1;
+}
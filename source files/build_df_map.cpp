@@ -4,30 +4,14 @@
 #include <string>
 #include <vector>
 #include <algorithm>
-#include "nlohmann/json.hpp" // For reading barrels and writing the final map
+#include "nlohmann/json.hpp" // For writing the final map
+#include "JsonScanner.hpp"  // For reading barrels
 
 using json = nlohmann::json;
 
 // LexID (int) -> Document Frequency (int)
 using DFMap = std::unordered_map<int, int>; 
 
-// --- Existing function placeholder (You need to adapt this from main.cpp) ---
-json loadBarrel(const std::string& barrelsDir, int barrelID) {
-    std::string path = barrelsDir + "/barrel_" + std::to_string(barrelID) + ".json";
-    std::ifstream fin(path);
-    if(!fin) {
-        std::cerr << "ERROR: Cannot open barrel file " << path << "\n";
-        // Do not exit here, just return an empty object to continue to the next barrel
-        return json::object(); 
-    }
-    json barrel;
-    fin >> barrel;
-    fin.close();
-    return barrel;
-}
-// ----------------------------------------------------------------------------
-
-
 DFMap generateDFMap(const std::string& barrelsDir, int totalBarrels) {
     DFMap dfMap;
 
@@ -35,25 +19,29 @@ DFMap generateDFMap(const std::string& barrelsDir, int totalBarrels) {
 
     for (int barrelID = 1; barrelID <= totalBarrels; ++barrelID) {
         std::cout << "Processing Barrel " << barrelID << "...\n";
-        json barrel = loadBarrel(barrelsDir, barrelID);
+        std::string path = barrelsDir + "/barrel_" + std::to_string(barrelID) + ".json";
+        JsonFile barrel;
+        if (!barrel.open(path)) {
+            std::cerr << "ERROR: Cannot open barrel file " << path << "\n";
+            continue; // Do not exit here, just continue to the next barrel
+        }
 
-        // Iterate through all LexIDs stored in this barrel
         // The structure inside the barrel is: { "LexID_str": { "DocID_str": freq, ... }, ... }
-        for (auto& [lexID_str, postings] : barrel.items()) {
-            try {
-                int lexID = std::stoi(lexID_str);
-                
-                // The Document Frequency (DF) is simply the number of entries
-                // in the posting list for this LexID.
-                int df = postings.size();
-                
-                // Store the result
-                dfMap[lexID] = df; 
-                
-            } catch (const std::exception& e) {
-                std::cerr << "Warning: Skipping invalid entry in barrel " << barrelID << ": " << e.what() << "\n";
+        // The Document Frequency (DF) is simply the number of entries in the
+        // posting list, so each list is counted by skipping over it.
+        JsonCursor cur = barrel.cursor();
+        cur.object([&](std::string_view lexID_str, JsonCursor& postings) {
+            int lexID;
+            if (!parseKey(lexID_str, lexID)) {
+                std::cerr << "Warning: Skipping invalid entry in barrel " << barrelID << ": " << lexID_str << "\n";
+                postings.skip();
+                return;
             }
-        }
+            dfMap[lexID] = static_cast<int>(postings.count());
+        });
+
+        if (!cur.ok())
+            std::cerr << "Warning: Malformed barrel " << path << ", DF map may be incomplete\n";
     }
     return dfMap;
 }
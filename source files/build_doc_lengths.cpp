@@ -0,0 +1,41 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "new_Semantic.cpp"
+
+// -------------------- BUILD DOC LENGTHS --------------------
+// Sums every document's term frequencies over all barrels (binary if
+// present, else JSON) into doc_lengths.bin (DocLengths.hpp), the length
+// column BM25 normalizes by. indexer.cpp writes the same file directly;
+// this rebuilds it for an index made by the JSON pipeline.
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cout << "Usage: build_doc_lengths <barrels_dir> [out.bin] [total_barrels=32]\n";
+        return 1;
+    }
+
+    std::string barrelsDir = argv[1];
+    std::string outFile = (argc > 2) ? argv[2] : docLengthsPath(barrelsDir);
+    int totalBarrels = (argc > 3) ? std::stoi(argv[3]) : 32;
+
+    std::vector<uint32_t> lengths;
+    for (int b = 0; b < totalBarrels; ++b) {
+        DecodedBarrel barrel = loadDecodedBarrel(barrelsDir, b);
+        for (size_t p = 0; p < barrel.docIDs.size(); ++p) {
+            uint32_t doc = barrel.docIDs[p];
+            if (doc >= lengths.size()) lengths.resize(doc + 1, 0);
+            lengths[doc] += barrel.freqs[p];
+        }
+    }
+
+    std::vector<char> image = DocLengths::build(lengths);
+    if (!DocLengths::save(outFile, image)) return 1;
+
+    DocLengths column;
+    if (!column.open(outFile)) return 1;
+
+    std::cout << "✓ Saved " << outFile << " (" << column.documents() << " documents, average length "
+              << column.averageLength() << ", " << image.size() << " bytes)\n";
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "new_Semantic.cpp"
+
+// -------------------- BUILD SEGMENT --------------------
+// Packs lexicon.json, df_map.json and every barrel into one lumi.seg.
+// Postings are taken from whichever barrel actually holds the lexID, so a
+// stale barrel map cannot drop terms.
+bool buildSegment(const std::string& lexFile,
+                  const std::string& mapFile,
+                  const std::string& dfFile,
+                  const std::string& barrelsDir,
+                  const std::string& outFile,
+                  int totalBarrels)
+{
+    auto lex       = loadLexicon(lexFile);
+    auto barrelMap = loadBarrelMap(mapFile);
+    auto df        = loadDFMap(dfFile);
+
+    std::vector<std::pair<std::vector<uint32_t>, std::vector<uint32_t>>> postings;
+    std::vector<int> foundIn;
+    uint32_t maxLexID = 0;
+    for (auto& [word, id] : lex) maxLexID = std::max(maxLexID, (uint32_t)id);
+
+    for (int b = 0; b < totalBarrels; ++b) {
+        DecodedBarrel barrel = loadDecodedBarrel(barrelsDir, b);
+        if (!barrel.lexIDs.empty()) maxLexID = std::max(maxLexID, barrel.lexIDs.back());
+        postings.resize(maxLexID + 1);
+        foundIn.resize(maxLexID + 1, -1);
+
+        for (size_t i = 0; i < barrel.lexIDs.size(); ++i) {
+            uint32_t id = barrel.lexIDs[i];
+            auto& [docs, freqs] = postings[id];
+            docs.assign(barrel.docIDs.begin() + barrel.offsets[i], barrel.docIDs.begin() + barrel.offsets[i + 1]);
+            freqs.assign(barrel.freqs.begin() + barrel.offsets[i], barrel.freqs.begin() + barrel.offsets[i + 1]);
+            foundIn[id] = b;
+        }
+        std::cout << "✓ Barrel " << b << ": " << barrel.lexIDs.size() << " terms\n";
+    }
+    postings.resize(maxLexID + 1);
+    foundIn.resize(maxLexID + 1, -1);
+
+    std::vector<TermMeta> meta(maxLexID + 1);
+    for (uint32_t id = 0; id <= maxLexID; ++id) {
+        auto dfIt = df.find(id);
+        meta[id].df = (dfIt != df.end()) ? dfIt->second : (uint32_t)postings[id].first.size();
+        auto bIt = barrelMap.find(id);
+        meta[id].barrel = (foundIn[id] >= 0) ? foundIn[id] : (bIt != barrelMap.end() ? bIt->second : 0);
+    }
+
+    std::vector<SegmentTerm> terms;
+    terms.reserve(lex.size());
+    for (auto& [word, id] : lex) terms.push_back({word, (uint32_t)id});
+
+    if (!writeIndexSegment(outFile, terms, std::move(meta), postings)) return false;
+
+    std::cout << "✓ Saved " << outFile << " (" << lex.size() << " terms, max lexID "
+              << maxLexID << ", " << fs::file_size(outFile) << " bytes)\n";
+    return true;
+}
+
+// -------------------- MAIN --------------------
+int main(int argc, char* argv[])
+{
+    if (argc < 6) {
+        std::cout << "Usage: build_segment <lexicon.json> <barrel_map.json> <df_map.json> "
+                  << "<barrels_dir> <out.seg> [total_barrels=32]\n";
+        return 1;
+    }
+
+    int totalBarrels = (argc > 6) ? std::stoi(argv[6]) : 32;
+    if (!buildSegment(argv[1], argv[2], argv[3], argv[4], argv[5], totalBarrels)) return 1;
+
+    // Make sure the result opens and report how long that takes
+    auto t1 = std::chrono::high_resolution_clock::now();
+    IndexSegment segment;
+    bool ok = segment.open(argv[5]);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << (ok ? "✅ Segment verified" : "❌ Segment failed to open") << " in "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "new_Semantic.cpp"
+
+// -------------------- BUILD TERM DICTIONARY --------------------
+// Freezes lexicon.json into a mappable lexicon.dict (TermDictionary.hpp),
+// then maps it back and checks every word against the JSON lexicon.
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        std::cout << "Usage: build_term_dictionary <lexicon.json> <out.dict>\n";
+        return 1;
+    }
+
+    auto lex = loadLexicon(argv[1]);
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::vector<char> image = TermDictionary::build(lex);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    if (!TermDictionary::save(argv[2], image)) return 1;
+
+    std::cout << "✓ Saved " << argv[2] << " (" << lex.size() << " terms, " << image.size()
+              << " bytes, built in " << std::chrono::duration<double, std::milli>(t2 - t1).count()
+              << " ms)\n";
+
+    TermDictionary dict;
+    if (!dict.open(argv[2])) return 1;
+
+    size_t bad = 0;
+    t1 = std::chrono::high_resolution_clock::now();
+    for (auto& [word, id] : lex)
+        if (dict.lookup(word) != id) bad++;
+    t2 = std::chrono::high_resolution_clock::now();
+
+    std::cout << (bad == 0 ? "✅ Dictionary verified" : "❌ Dictionary mismatch") << ": "
+              << lex.size() << " lookups in "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms";
+    if (bad) std::cout << " (" << bad << " wrong)";
+    std::cout << "\n";
+    return bad == 0 ? 0 : 1;
+}
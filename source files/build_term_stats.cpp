@@ -0,0 +1,38 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "new_Semantic.cpp"
+
+// -------------------- BUILD TERM STATS --------------------
+// Flattens barrel_map.json and df_map.json into term_stats.bin
+// (TermStats.hpp), then maps it back and checks it against the JSON.
+int main(int argc, char* argv[])
+{
+    if (argc < 4) {
+        std::cout << "Usage: build_term_stats <barrel_map.json> <df_map.json> <out.bin>\n";
+        return 1;
+    }
+
+    auto barrelMap = loadBarrelMap(argv[1]);
+    auto df        = loadDFMap(argv[2]);
+
+    std::vector<char> image = TermStats::build(barrelMap, df, TOTAL_DOCUMENTS);
+    if (!TermStats::save(argv[3], image)) return 1;
+
+    TermStats stats;
+    if (!stats.open(argv[3])) return 1;
+
+    size_t bad = 0;
+    for (auto& [id, b] : barrelMap)
+        if (stats.barrel(id) != b) bad++;
+    for (auto& [id, d] : df)
+        if (stats.df(id) != (uint32_t)d) bad++;
+
+    std::cout << "✓ Saved " << argv[3] << " (" << stats.size() << " lexIDs, "
+              << image.size() << " bytes; " << barrelMap.size() << " barrel + "
+              << df.size() << " DF entries)\n";
+    std::cout << (bad == 0 ? "✅ Term stats verified" : "❌ Term stats mismatch");
+    if (bad) std::cout << " (" << bad << " wrong)";
+    std::cout << "\n";
+    return bad == 0 ? 0 : 1;
+}
@@ -7,7 +7,9 @@
 #include <unordered_map>
 #include <algorithm>
 #include <cctype>
-#include "nlohmann.json.hpp"
+#include "nlohmann/json.hpp"
+#include "PositionIndex.hpp"
+#include "DocLengths.hpp"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
@@ -22,6 +24,10 @@ const int TOTAL_BARRELS = 32;              // As defined by your alpha*sub logic
 std::unordered_map<std::string, int> lexicon; 
 // invertedIndex: lexID -> { docID -> frequency }
 std::unordered_map<int, std::unordered_map<int, int>> invertedIndex; 
+// positionIndex: lexID -> { docID -> word offsets in the document }
+std::unordered_map<int, std::unordered_map<int, std::vector<uint32_t>>> positionIndex;
+// docLengths: docID -> number of indexed words (BM25 length normalization)
+std::vector<uint32_t> docLengths;
 
 int nextLexID = 1;
 
@@ -73,6 +79,7 @@ void processFile(const fs::path& filepath, int docID) {
     }
 
     std::string rawWord;
+    uint32_t position = 0; // Offset of the word among the document's indexed words
     while (file >> rawWord) {
         std::string word = cleanWord(rawWord);
         if (word.empty()) continue;
@@ -85,7 +92,12 @@ void processFile(const fs::path& filepath, int docID) {
 
         // 2. Build Inverted Index in RAM
         invertedIndex[lexID][docID]++;
+
+        // 3. Record where it occurs, for phrase queries
+        positionIndex[lexID][docID].push_back(position++);
     }
+    if (docLengths.size() <= static_cast<size_t>(docID)) docLengths.resize(docID + 1, 0);
+    docLengths[docID] = position;
     file.close();
 }
 
@@ -158,6 +170,24 @@ void saveSystem() {
         savedCount++;
     }
     std::cout << "✓ Saved " << savedCount << " barrel files in '" << BARRELS_DIR << "/'\n";
+
+    // --- D. Save Positions (one positions.pos beside the barrels, see PositionIndex.hpp) ---
+    std::vector<std::pair<uint32_t, TermPositions>> positionTerms;
+    positionTerms.reserve(positionIndex.size());
+    for (auto& [lexID, docMap] : positionIndex) {
+        TermPositions t;
+        for (auto& [docID, offsets] : docMap) {
+            t.docIDs.push_back(docID);
+            t.positions.push_back(std::move(offsets));
+        }
+        positionTerms.emplace_back(lexID, std::move(t));
+    }
+    if (writePositionIndex(positionIndexPath(BARRELS_DIR), std::move(positionTerms)))
+        std::cout << "✓ Saved " << positionIndexPath(BARRELS_DIR) << "\n";
+
+    // --- E. Save Document Lengths (doc_lengths.bin, see DocLengths.hpp) ---
+    if (DocLengths::save(docLengthsPath(BARRELS_DIR), DocLengths::build(docLengths)))
+        std::cout << "✓ Saved " << docLengthsPath(BARRELS_DIR) << "\n";
 }
 
 // ---------------------------------------------------------
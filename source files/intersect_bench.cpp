@@ -0,0 +1,169 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include "Intersect.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Microbenchmark for the sorted-array intersection kernels against the
+// unordered_map intersect() they replaced, both the probe alone and with
+// the map building the old getPostings() did. Lists are random sorted docIDs
+// over a fixed range; the short list is paired with longer ones at
+// increasing size ratios. Build with -O2 (-mavx2 for the block path).
+
+// -------------------- OLD INTERSECT (hash maps) --------------------
+using PostingList = std::unordered_map<int, int>;
+
+PostingList intersectHash(const PostingList& A, const PostingList& B) {
+    PostingList R;
+    const PostingList& small = (A.size() < B.size()) ? A : B;
+    const PostingList& large = (A.size() < B.size()) ? B : A;
+    for (auto& [doc, freq] : small) {
+        auto it = large.find(doc);
+        if (it != large.end()) R[doc] = freq + it->second;
+    }
+    return R;
+}
+
+// -------------------- DATA --------------------
+PostingArray randomPostings(size_t n, uint32_t universe, std::mt19937& rng) {
+    std::vector<uint32_t> ids;
+    ids.reserve(n * 2);
+    std::uniform_int_distribution<uint32_t> doc(0, universe - 1);
+    while (ids.size() < n) {
+        for (size_t i = ids.size(); i < n; ++i) ids.push_back(doc(rng));
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+
+    PostingArray list;
+    list.docIDs = std::move(ids);
+    std::uniform_int_distribution<uint32_t> freq(1, 20);
+    for (size_t i = 0; i < list.size(); ++i) list.freqs.push_back(freq(rng));
+    return list;
+}
+
+PostingList toHash(const PostingArray& list) {
+    PostingList map;
+    for (size_t i = 0; i < list.size(); ++i) map[list.docIDs[i]] = list.freqs[i];
+    return map;
+}
+
+// Best-of-repeats nanoseconds per call
+double bestNs(int repeats, int iterations, const std::function<void()>& fn) {
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto t1 = Clock::now();
+        for (int i = 0; i < iterations; ++i) fn();
+        auto t2 = Clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(t2 - t1).count() / iterations);
+    }
+    return best;
+}
+
+// Runs one kernel into a PostingArray so every variant is checked the same way
+using Kernel = size_t (*)(const uint32_t*, size_t, const uint32_t*, size_t, uint32_t*, uint32_t*);
+
+void runKernel(Kernel kernel, const PostingArray& a, const PostingArray& b, PostingArray& out,
+               std::vector<uint32_t>& posA, std::vector<uint32_t>& posB)
+{
+    size_t cap = std::min(a.size(), b.size());
+    posA.resize(cap);
+    posB.resize(cap);
+    size_t n = kernel(a.docIDs.data(), a.size(), b.docIDs.data(), b.size(), posA.data(), posB.data());
+    out.docIDs.resize(n);
+    out.freqs.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        out.docIDs[k] = a.docIDs[posA[k]];
+        out.freqs[k] = a.freqs[posA[k]] + b.freqs[posB[k]];
+    }
+}
+
+bool sameAsHash(const PostingArray& got, const PostingList& expected) {
+    if (got.size() != expected.size()) return false;
+    for (size_t k = 0; k < got.size(); ++k) {
+        auto it = expected.find(got.docIDs[k]);
+        if (it == expected.end() || (uint32_t)it->second != got.freqs[k]) return false;
+    }
+    return std::is_sorted(got.docIDs.begin(), got.docIDs.end());
+}
+
+int main(int argc, char* argv[])
+{
+    size_t shortSize = (argc > 1) ? std::stoul(argv[1]) : 1000;
+    int repeats = (argc > 2) ? std::max(1, std::stoi(argv[2])) : 5;
+    const uint32_t UNIVERSE = 50000000;
+
+    std::mt19937 rng(42);
+    std::cout << "Short list: " << shortSize << " postings, best of " << repeats << " runs (ns per intersection)\n";
+#ifdef LUMI_INTERSECT_AVX2
+    std::cout << "AVX2 block kernel: enabled\n\n";
+#else
+    std::cout << "AVX2 block kernel: not compiled in (build with -mavx2)\n\n";
+#endif
+
+    std::cout << std::left << std::setw(8) << "ratio" << std::right
+              << std::setw(12) << "map probe" << std::setw(12) << "map+build" << std::setw(12) << "linear"
+              << std::setw(12) << "gallop"
+#ifdef LUMI_INTERSECT_AVX2
+              << std::setw(12) << "avx2"
+#endif
+              << std::setw(12) << "dispatch" << std::setw(10) << "vs probe" << std::setw(10) << "vs build" << "\n";
+
+    for (size_t ratio : {1, 10, 100, 1000}) {
+        // Dense enough at 1:1 that a fair share of the short list matches
+        uint32_t universe = std::min<uint64_t>(UNIVERSE, shortSize * ratio * 4);
+        PostingArray a = randomPostings(shortSize, universe, rng);
+        PostingArray b = randomPostings(shortSize * ratio, universe, rng);
+        PostingList ha = toHash(a), hb = toHash(b);
+        PostingList expected = intersectHash(ha, hb);
+
+        int iterations = std::max<int>(1, static_cast<int>(2000000 / (shortSize * ratio)));
+        PostingArray out;
+        std::vector<uint32_t> posA, posB;
+        bool ok = true;
+
+        double hashNs = bestNs(repeats, iterations, [&] { volatile size_t n = intersectHash(ha, hb).size(); (void)n; });
+        // What a query paid before: both posting maps built, then probed
+        double buildNs = bestNs(repeats, iterations, [&] {
+            volatile size_t n = intersectHash(toHash(a), toHash(b)).size(); (void)n;
+        });
+
+        auto timeKernel = [&](Kernel kernel) {
+            runKernel(kernel, a, b, out, posA, posB);
+            ok &= sameAsHash(out, expected);
+            return bestNs(repeats, iterations, [&] { runKernel(kernel, a, b, out, posA, posB); });
+        };
+        double linearNs = timeKernel(intersectLinear);
+        double gallopNs = timeKernel(intersectGalloping);
+#ifdef LUMI_INTERSECT_AVX2
+        double blockNs = timeKernel(intersectBlocks);
+#endif
+
+        intersectSum(a.span(), b.span(), out);
+        ok &= sameAsHash(out, expected);
+        double dispatchNs = bestNs(repeats, iterations, [&] { intersectSum(a.span(), b.span(), out); });
+
+        if (!ok) {
+            std::cerr << "ERROR: Kernel output differs from the hash-map intersect at 1:" << ratio << "\n";
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(8) << ("1:" + std::to_string(ratio)) << std::right
+                  << std::fixed << std::setprecision(0)
+                  << std::setw(12) << hashNs << std::setw(12) << buildNs << std::setw(12) << linearNs << std::setw(12) << gallopNs
+#ifdef LUMI_INTERSECT_AVX2
+                  << std::setw(12) << blockNs
+#endif
+                  << std::setw(12) << dispatchNs
+                  << std::setw(9) << std::setprecision(1) << hashNs / dispatchNs << "x"
+                  << std::setw(9) << buildNs / dispatchNs << "x\n";
+    }
+    return 0;
+}
@@ -39,6 +39,11 @@ if query:
     with col1:
         st.subheader("C++ Retrieval")
         results = engine.search(query)
+        if not results and len(query.split()) > 1:
+            # No document has every word: rank the ones that have any of them
+            results = engine.search(query, mode=lumi_core.QueryMode.BLOCK_MAX_WAND)
+            if results:
+                st.caption("No document contains every word; showing the closest matches.")
         if results:
             for res in results[:5]:
                 st.success(f"📄 DocID: {res.docID} (Score: {round(res.score, 4)})")
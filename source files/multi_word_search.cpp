@@ -10,6 +10,8 @@
 #include <iomanip> // For std::setprecision
 #include <cmath>   // For log/sqrt in TF-IDF/Ranking
 #include "nlohmann/json.hpp" 
+#include "BinaryBarrel.hpp"
+#include "Intersect.hpp"
 #include "Scoring.hpp" // Contains ScoreMap, DFMap, SearchResult, rankResults (and presumably other declarations)
 
 // Include the new semantic utilities (Assuming these files contain the implementations from previous turns)
@@ -18,8 +20,8 @@
 
 using json = nlohmann::json;
 
-// Define a type for your posting lists: DocID (int) -> Frequency (int)
-using PostingList = std::unordered_map<int, int>; 
+// Posting lists are docID-sorted arrays (see Intersect.hpp)
+using PostingList = PostingArray;
 
 // Total number of documents. THIS MUST BE ACCURATE TO YOUR DATASET 
 const int TOTAL_DOCUMENTS = 50000; 
@@ -140,42 +142,47 @@ PostingList getWordPostings(
     
     int barrelID = map_it->second;
 
+    // Binary barrel (see build_binary_barrels.cpp) avoids parsing the whole JSON file
+    BarrelPostings bin;
+    if (readBinaryPostings(binaryBarrelPath(barrelsDir, barrelID), lexID, bin)) {
+        result.docIDs = std::move(bin.docIDs);
+        result.freqs = std::move(bin.freqs);
+        return result;
+    }
+
     json barrel = loadBarrel(barrelsDir, barrelID);
 
     std::string lexIDstr = std::to_string(lexID);
 
     if (!barrel.contains(lexIDstr)) return result; 
 
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
     for (auto& [docID_str, freq] : barrel[lexIDstr].items()) {
         try {
-            result[std::stoi(docID_str)] = freq; 
+            pairs.emplace_back(std::stoi(docID_str), freq.get<uint32_t>());
         } catch (const std::exception& e) {
             std::cerr << "Warning: Failed to convert DocID string to int: " << docID_str << "\n";
         }
     }
+
+    // JSON keys are not in docID order; intersection needs sorted lists
+    std::sort(pairs.begin(), pairs.end());
+    for (const auto& [docID, freq] : pairs) {
+        result.docIDs.push_back(docID);
+        result.freqs.push_back(freq);
+    }
     return result;
 }
 
 
 // ----------------------------------------------------
-// Merge (Intersect) two posting lists (Unchanged)
+// Merge (Intersect) two sorted posting lists
 // ----------------------------------------------------
 PostingList mergePostingLists(const PostingList& listA, const PostingList& listB) {
     PostingList mergedList;
-    const PostingList* smaller = (listA.size() < listB.size()) ? &listA : &listB;
-    const PostingList* larger = (listA.size() < listB.size()) ? &listB : &listA;
-
-    for (const auto& pair : *smaller) {
-        int docID = pair.first;
-        int freqA = pair.second;
-
-        auto it = larger->find(docID);
-        if (it != larger->end()) {
-            int freqB = it->second;
-            // Summing the frequencies (Total Term Frequency in Document)
-            mergedList[docID] = freqA + freqB;
-        }
-    }
+    // Gallops or merges the sorted arrays, summing the frequencies
+    // (Total Term Frequency in Document)
+    intersectSum(listA.span(), listB.span(), mergedList);
     return mergedList;
 }
 
@@ -235,36 +242,49 @@ void searchMultiWord(
     std::vector<std::string> words = tokenize(query);
     // ... (Existing intersection and initial posting list retrieval logic) ...
     
-    PostingList finalPostings = getWordPostings(words[0], lexMap, barrelMap, barrelsDir);
+    // Intersect rarest first (by DF), so each merge only shrinks a small list
+    std::vector<std::string> byDF = words;
+    auto dfOf = [&](const std::string& w) {
+        auto lexIt = lexMap.find(w);
+        if (lexIt == lexMap.end()) return 0;
+        auto dfIt = dfMap.find(lexIt->second);
+        return (dfIt != dfMap.end()) ? dfIt->second : 0;
+    };
+    std::stable_sort(byDF.begin(), byDF.end(),
+                     [&](const std::string& a, const std::string& b) { return dfOf(a) < dfOf(b); });
+
+    PostingList finalPostings = getWordPostings(byDF[0], lexMap, barrelMap, barrelsDir);
     
-    std::cout << "[DEBUG] First word '" << words[0] << "' retrieved " << finalPostings.size() << " postings.\n";
+    std::cout << "[DEBUG] Rarest word '" << byDF[0] << "' retrieved " << finalPostings.size() << " postings.\n";
 
     if (finalPostings.empty()) {
         std::cout << "No results found.\n";
         return;
     }
     
-    for (size_t i = 1; i < words.size(); ++i) {
-        PostingList nextPostings = getWordPostings(words[i], lexMap, barrelMap, barrelsDir);
-        std::cout << "[DEBUG] Merging with '" << words[i] << "' (" << nextPostings.size() << " postings).\n";
+    for (size_t i = 1; i < byDF.size(); ++i) {
+        PostingList nextPostings = getWordPostings(byDF[i], lexMap, barrelMap, barrelsDir);
+        std::cout << "[DEBUG] Merging with '" << byDF[i] << "' (" << nextPostings.size() << " postings).\n";
         finalPostings = mergePostingLists(finalPostings, nextPostings);
         
         if (finalPostings.empty()) {
-            std::cout << "No results found. (Intersection failed at word '" << words[i] << "')\n";
+            std::cout << "No results found. (Intersection failed at word '" << byDF[i] << "')\n";
             return;
         }
     }
 
     // STEP 3: Scoring and Ranking (Uses Scoring.hpp and SEMANTIC SEARCH)
     
-    ScoreMap scores;
+    // Dense per-thread accumulator, cleared when the scope ends
+    QueryScratch::Scope scope;
+    ScoreAccumulator& scores = scope.scratch().scores();
     const float SEMANTIC_WEIGHT = 0.35f; // <<< Tunable weight for the semantic score
 
     std::cout << "[INFO] Scoring " << finalPostings.size() << " documents...\n";
 
-    for (const auto& pair : finalPostings) {
-        int docID = pair.first;
-        int ttf = pair.second; // Total Term Frequency (TTF) of all query terms in this document
+    for (size_t k = 0; k < finalPostings.size(); ++k) {
+        int docID = finalPostings.docIDs[k];
+        int ttf = finalPostings.freqs[k]; // Total Term Frequency (TTF) of all query terms in this document
 
         // 1. Calculate TF-IDF Score
         float tfidf_score = calculateTFIDFScore(ttf, docID, lexMap, words, dfMap, TOTAL_DOCUMENTS); 
@@ -283,7 +303,7 @@ void searchMultiWord(
         
         // 3. Calculate Combined Final Score
         float finalScore = tfidf_score + (SEMANTIC_WEIGHT * semantic_score); 
-        scores[docID] = finalScore;
+        scores.add(docID, finalScore);
     }
     
 
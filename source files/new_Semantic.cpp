@@ -5,11 +5,36 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <map>
 #include <chrono>
 #include <cmath>
 #include <iomanip>
 #include <filesystem>
+#include <functional>
+#include <stdexcept>
+#include <memory_resource>
 #include "nlohmann/json.hpp"
+#include "BinaryBarrel.hpp"
+#include "BarrelStore.hpp"
+#include "BarrelCache.hpp"
+#include "IndexSegment.hpp"
+#include "TermDictionary.hpp"
+#include "TermStats.hpp"
+#include "JsonScanner.hpp"
+#include "BarrelSidecar.hpp"
+#include "Intersect.hpp"
+#include "Conjunction.hpp"
+#include "TopK.hpp"
+#include "Wand.hpp"
+#include "MaxScore.hpp"
+#include "QueryParser.hpp"
+#include "QueryIterators.hpp"
+#include "PositionIndex.hpp"
+#include "DocLengths.hpp"
+#include "BM25.hpp"
+#include "QueryScratch.hpp"
+#include "PairCache.hpp"
+#include "Parallel.hpp"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
@@ -18,13 +43,27 @@ namespace fs = std::filesystem;
 using PostingList = std::unordered_map<int,int>;   // docID -> frequency
 using DFMap       = std::unordered_map<int,int>;   // lexID -> df
 using ScoreMap    = std::unordered_map<int,float>; // docID -> score
+using QueryWords  = std::pmr::vector<std::pmr::string>; // tokens in the query arena
 
 struct SearchResult {
     int docID;
     float score;
 };
 
-const int TOTAL_DOCUMENTS = 50000;
+const int TOTAL_DOCUMENTS = 50000;   // N when the index has no doc_lengths.bin
+const size_t DEFAULT_TOP_K = 10;   // results returned when the caller gives no k
+
+// How the query words combine. And requires every word; the next three rank
+// documents holding any of them, pruned dynamically (Wand.hpp, MaxScore.hpp).
+// Boolean reads the query as AND / OR / NOT with parentheses and "phrases"
+// (QueryParser.hpp); an And query holding a quote is read the same way.
+enum class QueryMode {
+    And,
+    Wand,
+    BlockMaxWand,
+    MaxScore,
+    Boolean
+};
 
 // -------------------- TOKENIZER --------------------
 std::vector<std::string> tokenize(const std::string& q) {
@@ -38,6 +77,22 @@ std::vector<std::string> tokenize(const std::string& q) {
     return tokens;
 }
 
+// Same tokens as above, split in place into the query arena
+// (QueryScratch.hpp) instead of through a stringstream
+QueryWords tokenize(const std::string& q, std::pmr::memory_resource* mem) {
+    QueryWords tokens(mem);
+    size_t i = 0;
+    while (i < q.size()) {
+        while (i < q.size() && std::isspace(static_cast<unsigned char>(q[i]))) ++i;
+        size_t start = i;
+        while (i < q.size() && !std::isspace(static_cast<unsigned char>(q[i]))) ++i;
+        if (i == start) break;
+        tokens.emplace_back(q.data() + start, i - start);
+        for (char& c : tokens.back()) c = static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+    }
+    return tokens;
+}
+
 // -------------------- BARREL LOGIC --------------------
 int getBarrelID(const std::string& word) {
     char c = tolower(word[0]);
@@ -58,198 +113,530 @@ int getBarrelID(const std::string& word) {
 }
 
 // -------------------- LOAD LEXICON --------------------
-// -------------------- Updated Load Lexicon --------------------
+// Scanned straight into the map, no DOM. Accepts {"word": id},
+// {"word": [id, ...]} and a plain word list ({"lexicon": [...]} or [...]),
+// where IDs are assigned in order.
 std::unordered_map<std::string, int> loadLexicon(const std::string& lexFile) {
-    std::ifstream fin(lexFile);
-    if (!fin) {
+    JsonFile file;
+    if (!file.open(lexFile)) {
         std::cerr << "ERROR: Cannot open lexicon file\n";
         exit(1);
     }
 
-    json lexJson;
-    fin >> lexJson;
-    fin.close();
-
     std::unordered_map<std::string, int> lexicon;
+    int autoID = 1;
 
-    // Check if the JSON is an object or a specialized structure
-    auto& items = lexJson.contains("lexicon") ? lexJson["lexicon"] : lexJson;
-
-    for (auto& [word, val] : items.items()) {
-        // Fix: Handle both {"word": 1} and {"word": [1]}
-        if (val.is_array() && !val.empty()) {
-            lexicon[word] = val[0].get<int>();
-        } else if (val.is_number()) {
-            lexicon[word] = val.get<int>();
-        } else {
-            // If it's just a list of words, use the index as ID
-            static int autoID = 1;
-            lexicon[val.get<std::string>()] = autoID++;
+    auto readEntry = [&](std::string_view word, JsonCursor& c) {
+        if (c.isNumber()) {
+            lexicon[std::string(word)] = static_cast<int>(c.integer());
+            return;
         }
+        if (!c.isArray()) { c.skip(); return; }
+
+        bool first = true;
+        c.array([&](JsonCursor& e) {
+            if (e.isString()) lexicon[e.string()] = autoID++;               // word list
+            else if (first && e.isNumber()) lexicon[std::string(word)] = static_cast<int>(e.integer());
+            else e.skip();
+            first = false;
+        });
+    };
+
+    JsonCursor cur = file.cursor();
+    if (cur.isArray()) readEntry("", cur);
+    else cur.object(readEntry);
+
+    if (!cur.ok()) {
+        std::cerr << "ERROR: Malformed lexicon file " << lexFile << "\n";
+        exit(1);
     }
     return lexicon;
 }
 
-// -------------------- Updated Load Barrel Mapping --------------------
+// -------------------- LOAD TERM DICTIONARY --------------------
+// A saved dictionary (build_term_dictionary.cpp) is mapped as is;
+// lexicon.json is parsed once and frozen into a dictionary image.
+TermDictionary loadTermDictionary(const std::string& lexFile) {
+    TermDictionary dict;
+
+    char magic[4] = {};
+    std::ifstream fin(lexFile, std::ios::binary);
+    fin.read(magic, 4);
+    if (fin && std::memcmp(magic, DICT_MAGIC, 4) == 0) {
+        fin.close();
+        if (!dict.open(lexFile)) {
+            std::cerr << "ERROR: Cannot open term dictionary\n";
+            exit(1);
+        }
+        return dict;
+    }
+
+    dict.assign(TermDictionary::build(loadLexicon(lexFile)));
+    return dict;
+}
+
+// -------------------- LOAD BARREL MAPPING --------------------
+// {"lexID": barrelID} or {"lexID": [barrelID]}
 std::unordered_map<int, int> loadBarrelMap(const std::string& mapFile) {
-    std::ifstream fin(mapFile);
-    if (!fin) {
+    JsonFile file;
+    if (!file.open(mapFile)) {
         std::cerr << "ERROR: Cannot open barrel map file\n";
         exit(1);
     }
 
-    json mapJson;
-    fin >> mapJson;
-    fin.close();
-
     std::unordered_map<int, int> barrelMap;
-
-    for (auto& [lexID, barrelIDVal] : mapJson.items()) {
-        int lID = std::stoi(lexID);
-        // Fix: If barrelID is [5], extract the 5.
-        if (barrelIDVal.is_array() && !barrelIDVal.empty()) {
-            barrelMap[lID] = barrelIDVal[0].get<int>();
+    JsonCursor cur = file.cursor();
+    cur.object([&](std::string_view key, JsonCursor& c) {
+        int lexID;
+        if (!parseKey(key, lexID)) { c.skip(); return; }
+        if (c.isArray()) {
+            bool first = true;
+            c.array([&](JsonCursor& e) {
+                if (first && e.isNumber()) barrelMap[lexID] = static_cast<int>(e.integer());
+                else e.skip();
+                first = false;
+            });
         } else {
-            barrelMap[lID] = barrelIDVal.get<int>();
+            barrelMap[lexID] = static_cast<int>(c.integer());
         }
+    });
+
+    if (!cur.ok()) {
+        std::cerr << "ERROR: Malformed barrel map file " << mapFile << "\n";
+        exit(1);
     }
     return barrelMap;
 }
+
 // -------------------- LOAD DF MAP --------------------
 DFMap loadDFMap(const std::string& file) {
-    std::ifstream fin(file);
-    json j; fin >> j;
+    JsonFile in;
+    if (!in.open(file)) {
+        std::cerr << "ERROR: Cannot open DF map file\n";
+        exit(1);
+    }
 
     DFMap df;
-    for (auto& [k,v] : j.items())
-        df[std::stoi(k)] = v;
+    JsonCursor cur = in.cursor();
+    cur.object([&](std::string_view key, JsonCursor& c) {
+        int lexID;
+        if (parseKey(key, lexID)) df[lexID] = static_cast<int>(c.integer());
+        else c.skip();
+    });
+
+    if (!cur.ok()) {
+        std::cerr << "ERROR: Malformed DF map file " << file << "\n";
+        exit(1);
+    }
     return df;
 }
 
+// -------------------- LOAD TERM STATS --------------------
+// A saved term_stats.bin (build_term_stats.cpp) is mapped as is and
+// dfFile is ignored; otherwise both JSON maps are flattened into arrays.
+TermStats loadTermStats(const std::string& mapFile, const std::string& dfFile) {
+    TermStats stats;
+
+    char magic[4] = {};
+    std::ifstream fin(mapFile, std::ios::binary);
+    fin.read(magic, 4);
+    if (fin && std::memcmp(magic, TERM_STATS_MAGIC, 4) == 0) {
+        fin.close();
+        if (!stats.open(mapFile)) {
+            std::cerr << "ERROR: Cannot open term stats\n";
+            exit(1);
+        }
+        return stats;
+    }
+
+    stats.assign(TermStats::build(loadBarrelMap(mapFile), loadDFMap(dfFile), TOTAL_DOCUMENTS));
+    return stats;
+}
+
 // -------------------- LOAD BARREL --------------------
-json loadBarrel(const std::string& dir, int id) {
-    std::ifstream fin(dir + "/barrel_" + std::to_string(id) + ".json");
-    json j; fin >> j;
-    return j;
+std::string jsonBarrelPath(const std::string& dir, int id) {
+    return dir + "/barrel_" + std::to_string(id) + ".json";
+}
+
+// barrel_N.bin is built from barrel_N.json; once the JSON has been written
+// since (addDocument() or an outside edit) the binary copy is stale.
+bool binaryBarrelIsCurrent(const std::string& dir, int id)
+{
+    std::error_code ec;
+    auto binTime = fs::last_write_time(binaryBarrelPath(dir, id), ec);
+    if (ec) return false;
+    auto jsonTime = fs::last_write_time(jsonBarrelPath(dir, id), ec);
+    return ec || binTime >= jsonTime;
+}
+
+// One barrel entry {"docID": freq, ...}; a position list counts as its size
+template <typename OnPosting>
+void scanPostingObject(JsonCursor& cur, OnPosting&& onPosting) {
+    cur.object([&](std::string_view doc, JsonCursor& c) {
+        int docID;
+        if (!parseKey(doc, docID)) { c.skip(); return; }
+        uint32_t freq = c.isArray() ? static_cast<uint32_t>(c.count()) : static_cast<uint32_t>(c.integer());
+        onPosting(docID, freq);
+    });
 }
 
 // -------------------- GET POSTINGS --------------------
-PostingList getPostings(const std::string& word,
-                        const std::unordered_map<std::string,int>& lex,
-                        const std::unordered_map<int,int>& barrelMap,
-                        const std::string& barrelDir)
+// JSON barrels are keyed by docID string, so their postings are collected
+// as pairs and sorted into docID order.
+void fillPostingArray(std::vector<std::pair<uint32_t,uint32_t>>& pairs, PostingArray& out)
 {
-    PostingList list;
+    std::sort(pairs.begin(), pairs.end());
+    out.docIDs.resize(pairs.size());
+    out.freqs.resize(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        out.docIDs[i] = pairs[i].first;
+        out.freqs[i] = pairs[i].second;
+    }
+}
+
+PostingArray getPostings(const std::string& word,
+                         const std::unordered_map<std::string,int>& lex,
+                         const std::unordered_map<int,int>& barrelMap,
+                         const std::string& barrelDir)
+{
+    PostingArray list;
     if (!lex.count(word)) return list;
 
     int lexID = lex.at(word);
     if (!barrelMap.count(lexID)) return list;
 
-    json barrel = loadBarrel(barrelDir, barrelMap.at(lexID));
-    std::string key = std::to_string(lexID);
+    // Prefer the binary barrel: one seek + read instead of a full JSON parse
+    BarrelPostings bin;
+    if (binaryBarrelIsCurrent(barrelDir, barrelMap.at(lexID)) &&
+        readBinaryPostings(binaryBarrelPath(barrelDir, barrelMap.at(lexID)), lexID, bin)) {
+        list.docIDs = std::move(bin.docIDs);
+        list.freqs = std::move(bin.freqs);
+        return list;
+    }
+
+    std::vector<std::pair<uint32_t,uint32_t>> pairs;
+    auto collect = [&](int doc, uint32_t freq) { pairs.emplace_back(static_cast<uint32_t>(doc), freq); };
 
-    if (!barrel.contains(key)) return list;
+    // Next best: the sidecar gives the byte range of just this term
+    std::string jsonPath = jsonBarrelPath(barrelDir, barrelMap.at(lexID));
+    std::string slice;
+    if (readBarrelSlice(jsonPath, barrelSidecarPath(barrelDir, barrelMap.at(lexID)), lexID, slice)) {
+        if (slice.empty()) return list;
+        JsonCursor entry(slice);
+        scanPostingObject(entry, collect);
+        fillPostingArray(pairs, list);
+        return list;
+    }
+
+    // Scan for the one key; every other entry is skipped, not parsed
+    JsonFile file;
+    if (!file.open(jsonPath)) return list;
 
-    for (auto& [doc, freq] : barrel[key].items())
-        list[std::stoi(doc)] = freq;
+    std::string key = std::to_string(lexID);
+    JsonCursor cur = file.cursor();
+    cur.object([&](std::string_view k, JsonCursor& c) {
+        if (k != key) { c.skip(); return true; }
+        scanPostingObject(c, collect);
+        return false;
+    });
 
+    fillPostingArray(pairs, list);
     return list;
 }
 
-// -------------------- MERGE POSTINGS --------------------
-PostingList intersect(const PostingList& A, const PostingList& B) {
-    PostingList R;
-    const PostingList *small = &A, *large = &B;
-    if (A.size() > B.size()) std::swap(small, large);
+// -------------------- GET POSTINGS (MAPPED) --------------------
+// Zero-copy for raw barrels, block-at-a-time for block barrels;
+// other compressed barrels are decoded into scratch.
+PostingCursor getPostingCursor(std::string_view word,
+                               const TermDictionary& lex,
+                               const TermStats& stats,
+                               const BarrelStore& barrels,
+                               BarrelPostings& scratch)
+{
+    int lexID = lex.lookup(word);
+    if (lexID < 0) return {};
 
-    for (auto& [doc,f] : *small)
-        if (large->count(doc))
-            R[doc] = f + large->at(doc);
+    int barrelID = stats.barrel(lexID);
+    if (barrelID < 0) return {};
 
-    return R;
+    return barrels.cursor(barrelID, lexID, scratch);
 }
 
-// -------------------- TF-IDF --------------------
-float tfidfScore(int ttf,
-                 const std::vector<std::string>& words,
-                 const std::unordered_map<std::string,int>& lex,
-                 const DFMap& df)
+// -------------------- DECODE WHOLE BARREL --------------------
+// Decodes every posting list of a barrel (binary if present and current,
+// else JSON) into flat arrays for BarrelCache.
+DecodedBarrel loadDecodedBarrel(const std::string& dir, int id)
 {
-    float score = 0.0f;
-    for (const auto& w : words) {
-        int id = lex.at(w);
-        if (df.count(id)) {
-            float idf = std::log((float)TOTAL_DOCUMENTS / (1.0f + df.at(id)));
-            score += ttf * idf;
+    DecodedBarrel out;
+    out.offsets.push_back(0);
+
+    std::ifstream bin;
+    if (binaryBarrelIsCurrent(dir, id)) bin.open(binaryBarrelPath(dir, id), std::ios::binary);
+    if (bin.is_open()) {
+        std::vector<char> image((std::istreambuf_iterator<char>(bin)), std::istreambuf_iterator<char>());
+        const auto* header = reinterpret_cast<const BarrelHeader*>(image.data());
+        const auto* table = reinterpret_cast<const BarrelTermEntry*>(image.data() + sizeof(BarrelHeader));
+
+        // Check the table and every block's extent before decoding any of it
+        bool valid = image.size() >= sizeof(BarrelHeader) &&
+                     std::memcmp(header->magic, BARREL_MAGIC, 4) == 0 &&
+                     isKnownBarrelVersion(header->version);
+        size_t dataStart = valid ? sizeof(BarrelHeader) + static_cast<size_t>(header->termCount) * sizeof(BarrelTermEntry) : 0;
+        valid = valid && dataStart <= image.size();
+        for (size_t i = 0; valid && i < header->termCount; ++i) {
+            valid = table[i].offset >= dataStart && table[i].offset <= image.size() &&
+                    barrelBlockSize(*header, table, i, image.size()) <= image.size() - table[i].offset;
+        }
+
+        if (valid) {
+            BarrelPostings p;
+            for (size_t i = 0; i < header->termCount; ++i) {
+                valid = decodeBarrelBlock(header->version, image.data() + table[i].offset,
+                                          barrelBlockSize(*header, table, i, image.size()), table[i].length, p);
+                if (!valid) break;
+                out.lexIDs.push_back(table[i].lexID);
+                out.docIDs.insert(out.docIDs.end(), p.docIDs.begin(), p.docIDs.end());
+                out.freqs.insert(out.freqs.end(), p.freqs.begin(), p.freqs.end());
+                out.offsets.push_back(static_cast<uint32_t>(out.docIDs.size()));
+            }
+            if (valid) {
+                out.computeMaxFreqs();
+                return out;
+            }
+            out = DecodedBarrel();      // a block did not decode: start over from JSON
+            out.offsets.push_back(0);
         }
+        std::cerr << "Warning: Ignoring invalid binary barrel " << binaryBarrelPath(dir, id) << "\n";
     }
-    return score;
+
+    JsonFile file;
+    if (!file.open(jsonBarrelPath(dir, id))) return out;
+
+    // First pass only records where each term's object is
+    std::vector<std::pair<uint32_t, std::string_view>> terms;
+    JsonCursor cur = file.cursor();
+    cur.object([&](std::string_view key, JsonCursor& c) {
+        int lexID;
+        if (parseKey(key, lexID)) terms.emplace_back(static_cast<uint32_t>(lexID), c.raw());
+        else c.skip();
+    });
+    std::sort(terms.begin(), terms.end(),
+              [](auto& a, auto& b){ return a.first < b.first; });
+
+    std::vector<std::pair<uint32_t,uint32_t>> postings;
+    for (auto& [lexID, docs] : terms) {
+        postings.clear();
+        JsonCursor entry(docs);
+        scanPostingObject(entry, [&](int doc, uint32_t freq) {
+            postings.emplace_back(static_cast<uint32_t>(doc), freq);
+        });
+        std::sort(postings.begin(), postings.end());
+
+        out.lexIDs.push_back(lexID);
+        for (auto& [doc, freq] : postings) {
+            out.docIDs.push_back(doc);
+            out.freqs.push_back(freq);
+        }
+        out.offsets.push_back(static_cast<uint32_t>(out.docIDs.size()));
+    }
+    out.computeMaxFreqs();
+    return out;
+}
+
+// -------------------- MERGE POSTINGS --------------------
+// Sorted-array intersection (Intersect.hpp); frequencies are summed.
+PostingArray intersect(const PostingArray& A, const PostingArray& B) {
+    PostingArray R;
+    intersectSum(A.span(), B.span(), R);
+    return R;
+}
+
+// -------------------- BM25 --------------------
+// Model for callers without a length column (the JSON path): every
+// document counts as average length and N is TOTAL_DOCUMENTS.
+BM25 defaultBM25(BM25Params params = BM25Params())
+{
+    BM25 model;
+    model.configure(nullptr, TOTAL_DOCUMENTS, params);
+    return model;
 }
 
 // -------------------- SEMANTIC BOOST --------------------
-float semanticBoost(const PostingList& docTerms,
-                    const std::vector<std::string>& words,
+// Fraction of the query words that are in the lexicon and occur in the
+// doc. An intersected doc holds every word, so this is the same for all of
+// them and computed once per query.
+float semanticBoost(const std::vector<std::string>& words,
                     const std::unordered_map<std::string,int>& lex)
 {
     int count = 0;
     for (const auto& w : words) {
-        if (lex.count(w) && docTerms.count(lex.at(w))) count++;
+        if (lex.count(w)) count++;
     }
     return (float)count / (float)words.size();
 }
 
-// -------------------- SEARCH --------------------
-void search(const std::string& query,
-            const std::unordered_map<std::string,int>& lex,
-            const std::unordered_map<int,int>& barrelMap,
-            const DFMap& df,
-            const std::string& barrelDir)
-{
-    auto words = tokenize(query);
+// -------------------- QUERY CONTEXT --------------------
+// Every query word's posting list, fetched exactly once per query.
+// postings[i] belongs to words[i]; repeated words share one fetch.
+struct QueryContext {
+    std::vector<std::string> words;
+    std::vector<PostingArray> postings;
+};
 
-    PostingList result = getPostings(words[0], lex, barrelMap, barrelDir);
-    if (result.empty()) { std::cout << "No results\n"; return; }
+// Docs containing every query word, ascending; tfs[w][k] is the frequency
+// of words[w] in docIDs[k] (parallel arrays, one per query word).
+struct Intersection {
+    std::vector<uint32_t> docIDs;
+    std::vector<std::vector<uint32_t>> tfs;
+};
+
+QueryContext buildQueryContext(const std::string& query,
+                               const std::unordered_map<std::string,int>& lex,
+                               const std::unordered_map<int,int>& barrelMap,
+                               const std::string& barrelDir)
+{
+    QueryContext ctx;
+    ctx.words = tokenize(query);
+    ctx.postings.resize(ctx.words.size());
 
-    for (size_t i=1;i<words.size();++i) {
-        result = intersect(result, getPostings(words[i], lex, barrelMap, barrelDir));
-        if (result.empty()) { std::cout << "No results\n"; return; }
+    std::unordered_map<std::string, size_t> fetched;
+    for (size_t i = 0; i < ctx.words.size(); ++i) {
+        auto it = fetched.find(ctx.words[i]);
+        if (it != fetched.end()) {
+            ctx.postings[i] = ctx.postings[it->second];
+        } else {
+            ctx.postings[i] = getPostings(ctx.words[i], lex, barrelMap, barrelDir);
+            fetched[ctx.words[i]] = i;
+        }
     }
+    return ctx;
+}
 
-    std::vector<SearchResult> ranked;
-    const float SEMANTIC_WEIGHT = 0.35f;
+// Intersects the lists shortest first, narrowing the candidate set with
+// each one and gathering that word's frequencies by matched position.
+Intersection intersect(const QueryContext& ctx) {
+    Intersection result;
+    size_t n = ctx.postings.size();
+    if (n == 0) return result;
 
-    for (auto& [doc, ttf] : result) {
-        float baseScore = tfidfScore(ttf, words, lex, df);
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return ctx.postings[a].size() < ctx.postings[b].size(); });
 
-        PostingList docTerms;
-        for (auto& w : words) {
-            if (lex.count(w)) {
-                int lexID = lex.at(w);
-                docTerms[lexID] = getPostings(w, lex, barrelMap, barrelDir)[doc];
-            }
+    result.tfs.resize(n);
+    result.docIDs = ctx.postings[order[0]].docIDs;
+    result.tfs[order[0]] = ctx.postings[order[0]].freqs;
+
+    std::vector<uint32_t> posCand, posList;
+    for (size_t step = 1; step < n && !result.docIDs.empty(); ++step) {
+        const PostingArray& list = ctx.postings[order[step]];
+        PostingSpan cand{result.docIDs.data(), nullptr, static_cast<uint32_t>(result.docIDs.size())};
+        size_t m = intersectPositions(cand, list.span(), posCand, posList);
+
+        // Keep only the surviving candidates in every array gathered so far
+        for (size_t k = 0; k < m; ++k) result.docIDs[k] = result.docIDs[posCand[k]];
+        result.docIDs.resize(m);
+        for (size_t prev = 0; prev < step; ++prev) {
+            auto& tf = result.tfs[order[prev]];
+            for (size_t k = 0; k < m; ++k) tf[k] = tf[posCand[k]];
+            tf.resize(m);
         }
 
-        float semantic = semanticBoost(docTerms, words, lex);
-        float finalScore = baseScore + SEMANTIC_WEIGHT * semantic;
-        ranked.push_back({doc, finalScore});
+        auto& tf = result.tfs[order[step]];
+        tf.resize(m);
+        for (size_t k = 0; k < m; ++k) tf[k] = list.freqs[posList[k]];
     }
 
-    std::sort(ranked.begin(), ranked.end(),
-              [](auto&a, auto&b){ return a.score > b.score; });
+    if (result.docIDs.empty())
+        for (auto& tf : result.tfs) tf.clear();
+    return result;
+}
+
+// Scores every intersected doc from the context with BM25 over each
+// word's own TF; the best k, best first.
+std::vector<SearchResult> rankContext(const QueryContext& ctx,
+                                      const std::unordered_map<std::string,int>& lex,
+                                      const DFMap& df,
+                                      size_t k = DEFAULT_TOP_K,
+                                      const BM25& model = defaultBM25())
+{
+    QueryScratch::Scope scope;
+    TopK<SearchResult> top(k, scope.memory());
+    const float SEMANTIC_WEIGHT = 0.35f;
+
+    // Words without a DF entry weigh nothing
+    std::vector<float> idfs(ctx.words.size(), 0.0f);
+    for (size_t i = 0; i < ctx.words.size(); ++i) {
+        auto it = lex.find(ctx.words[i]);
+        if (it == lex.end()) continue;
+        auto dfIt = df.find(it->second);
+        if (dfIt != df.end()) idfs[i] = model.idf(dfIt->second);
+    }
+
+    Intersection hits = intersect(ctx);
+    float semantic = ctx.words.empty() ? 0.0f : semanticBoost(ctx.words, lex);
+    for (size_t n = 0; n < hits.docIDs.size(); ++n) {
+        uint32_t doc = hits.docIDs[n];
+        float baseScore = 0.0f;
+        for (size_t i = 0; i < ctx.words.size(); ++i)
+            baseScore += model.termScore(idfs[i], hits.tfs[i][n], doc);
+        top.push({(int)doc, baseScore + SEMANTIC_WEIGHT * semantic});
+    }
+    return top.take();
+}
+
+// -------------------- SEARCH --------------------
+void search(const std::string& query,
+            const std::unordered_map<std::string,int>& lex,
+            const std::unordered_map<int,int>& barrelMap,
+            const DFMap& df,
+            const std::string& barrelDir)
+{
+    QueryContext ctx = buildQueryContext(query, lex, barrelMap, barrelDir);
+    std::vector<SearchResult> ranked = rankContext(ctx, lex, df, 10);
+    if (ranked.empty()) { std::cout << "No results\n"; return; }
 
     std::cout << "\n=== RESULTS ===\n";
-    for (size_t i=0;i<std::min(ranked.size(), size_t(10));++i)
+    for (size_t i=0;i<ranked.size();++i)
         std::cout << i+1 << ". Doc " << ranked[i].docID
                   << " Score: " << ranked[i].score << "\n";
 }
 
 // -------------------- DYNAMIC ADDITION --------------------
+// Writes a whole file and renames it into place, so a search decoding the
+// file meanwhile (LumiEngine searches run concurrently) sees the old or
+// the new contents, never half of them.
+void writeJsonFile(const std::string& path, const json& j)
+{
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream fout(tmp);
+        fout << std::setw(2) << j << std::endl;
+    }
+    fs::rename(tmp, path);
+}
+
+// {"lexID": value, ...}, the form loadBarrelMap() / loadDFMap() read
+// (json(map) of an int-keyed map would give an array of pairs)
+json intMapJson(const std::unordered_map<int,int>& map)
+{
+    json j = json::object();
+    for (const auto& [key, value] : map) j[std::to_string(key)] = value;
+    return j;
+}
+
+// Adds docID to the barrels in barrelDir and writes the extended maps
+// back to the files they were loaded from (lexPath, mapPath, dfPath).
 void addDocument(int docID,
                  const std::string& content,
                  std::unordered_map<std::string,int>& lex,
                  DFMap& df,
                  std::unordered_map<int,int>& barrelMap,
-                 const std::string& barrelDir)
+                 const std::string& barrelDir,
+                 const std::string& lexPath,
+                 const std::string& mapPath,
+                 const std::string& dfPath)
 {
     auto words = tokenize(content);
     std::unordered_map<int,int> termFreq;
@@ -282,20 +669,17 @@ void addDocument(int docID,
         barrelsToUpdate[barrelID][std::to_string(lexID)][std::to_string(docID)] = freq;
     }
 
+    // The binary copy of a rewritten barrel no longer matches; drop it so
+    // readers fall back to the JSON (and its sidecar) until it is rebuilt
     for (auto& [barrelID, barrelJson] : barrelsToUpdate) {
-        std::ofstream fout(barrelDir + "/barrel_" + std::to_string(barrelID) + ".json");
-        fout << std::setw(2) << barrelJson << std::endl;
+        writeJsonFile(barrelDir + "/barrel_" + std::to_string(barrelID) + ".json", barrelJson);
+        std::error_code ec;
+        fs::remove(binaryBarrelPath(barrelDir, barrelID), ec);
     }
 
-    {
-        std::ofstream fout(barrelDir + "/barrelMap.json"); json jMap(barrelMap); fout << std::setw(2) << jMap << std::endl;
-    }
-    {
-        std::ofstream fout(barrelDir + "/df.json"); json jDF(df); fout << std::setw(2) << jDF << std::endl;
-    }
-    {
-        std::ofstream fout(barrelDir + "/lexicon.json"); json jLex(lex); fout << std::setw(2) << jLex << std::endl;
-    }
+    writeJsonFile(mapPath, intMapJson(barrelMap));
+    writeJsonFile(dfPath, intMapJson(df));
+    writeJsonFile(lexPath, json(lex));
 
     std::cout << "Document " << docID << " added successfully!\n";
 }
@@ -305,45 +689,733 @@ std::vector<SearchResult> run_search(
     const std::unordered_map<std::string,int>& lex,
     const std::unordered_map<int,int>& barrelMap,
     const DFMap& df,
-    const std::string& barrelDir)
+    const std::string& barrelDir,
+    size_t k = DEFAULT_TOP_K)
 {
-    auto words = tokenize(query);
+    QueryContext ctx = buildQueryContext(query, lex, barrelMap, barrelDir);
+    return rankContext(ctx, lex, df, k);
+}
 
-    PostingList result = getPostings(words[0], lex, barrelMap, barrelDir);
-    if (result.empty()) return {};
+// -------------------- RANK INTERSECTION --------------------
+// Same ranking as run_search() above, but walks posting cursors instead
+// of materialized posting arrays. A Conjunction led by the lowest-DF
+// cursor (costs[i] is the DF of cursors[i]) advance()s the others to each
+// candidate, so block barrels skip every block that cannot contain it.
+// idfs[i] is the BM25 IDF of cursors[i]'s word (0 without a DF entry);
+// semantic is the constant boost, since every term occurs in every
+// intersected doc. Only the best k are kept (TopK.hpp), in the memory
+// resource of the cursor list. Matches from endDoc on are left out (one
+// range of a partitioned query, see rankPartitioned()).
+std::vector<SearchResult> rankIntersection(
+    std::pmr::vector<PostingCursor>& cursors,
+    const std::pmr::vector<uint32_t>& costs,
+    const std::pmr::vector<float>& idfs,
+    const BM25& model,
+    float semantic,
+    size_t k,
+    uint32_t endDoc = std::numeric_limits<uint32_t>::max())
+{
+    TopK<SearchResult> top(k, cursors.get_allocator().resource());
+    const float SEMANTIC_WEIGHT = 0.35f;
 
-    for (size_t i=1;i<words.size();++i) {
-        result = intersect(result, getPostings(words[i], lex, barrelMap, barrelDir));
-        if (result.empty()) return {};
+    for (Conjunction<> match(cursors, costs); !match.atEnd() && match.docID() < endDoc; match.next()) {
+        uint32_t doc = match.docID();
+        float baseScore = 0.0f;
+        for (size_t i = 0; i < cursors.size(); ++i)
+            baseScore += model.termScore(idfs[i], cursors[i].freq(), doc);
+        top.push({(int)doc, baseScore + SEMANTIC_WEIGHT * semantic});
     }
+    return top.take();
+}
 
-    std::vector<SearchResult> ranked;
+// -------------------- RANK DISJUNCTION --------------------
+// Ranked OR with the per-document formula of rankIntersection(): every
+// matched word adds its BM25 share and its share of the semantic boost
+// (semanticBoost()). A doc holding all the words therefore scores exactly
+// as under AND.
+std::pmr::vector<TermScorer> disjunctionScorers(const std::pmr::vector<float>& idfs, const BM25& model)
+{
     const float SEMANTIC_WEIGHT = 0.35f;
 
-    for (auto& [doc, ttf] : result) {
-        float baseScore = tfidfScore(ttf, words, lex, df);
+    std::pmr::vector<TermScorer> scorers(idfs.get_allocator());
+    scorers.reserve(idfs.size());
+    for (float idf : idfs) scorers.push_back({&model, idf, SEMANTIC_WEIGHT / (float)idfs.size()});
+    return scorers;
+}
+
+std::vector<SearchResult> rankDisjunction(
+    std::pmr::vector<PostingCursor>& cursors,
+    const std::pmr::vector<float>& idfs,
+    const BM25& model,
+    size_t k,
+    QueryMode mode,
+    uint32_t endDoc = std::numeric_limits<uint32_t>::max())
+{
+    if (cursors.empty()) return {};
+    std::pmr::vector<TermScorer> scorers = disjunctionScorers(idfs, model);
+    if (mode == QueryMode::MaxScore)
+        return maxScoreSearch<SearchResult>(cursors, scorers, k, endDoc);
+    return wandSearch<SearchResult>(cursors, scorers, k, mode == QueryMode::BlockMaxWand, endDoc);
+}
+
+// Evaluates the cursors (one per query word) in the given mode, over
+// docIDs below endDoc
+std::vector<SearchResult> rankRange(
+    std::pmr::vector<PostingCursor>& cursors,
+    const std::pmr::vector<uint32_t>& costs,
+    const std::pmr::vector<float>& idfs,
+    const BM25& model,
+    float semantic,
+    size_t k,
+    QueryMode mode,
+    uint32_t endDoc = std::numeric_limits<uint32_t>::max())
+{
+    if (mode == QueryMode::And)
+        return rankIntersection(cursors, costs, idfs, model, semantic, k, endDoc);
+    return rankDisjunction(cursors, idfs, model, k, mode, endDoc);
+}
+
+// -------------------- PARTITIONED RANKING --------------------
+// A broad query can be split into docID ranges ranked on several threads
+// (Parallel.hpp). Each worker advance()s its own copies of the cursors to
+// the start of its range (block lists skip there by their skip entries),
+// ranks up to the range end into its own top k, and the per-range lists
+// are merged at the end. Every doc falls in exactly one range and scores
+// the same there, and TopK breaks ties by docID, so the results are those
+// of the serial evaluation, bit for bit.
+//
+// The ranges cut the list that drives the work into runs of equal length:
+// the cheapest list under AND (it proposes every candidate), the longest
+// otherwise. Each range keeps its own pruning threshold, so the ranked-OR
+// modes prune somewhat less than serially.
 
-        PostingList docTerms;
-        for (auto& w : words) {
-            if (lex.count(w)) {
-                int lexID = lex.at(w);
-                docTerms[lexID] = getPostings(w, lex, barrelMap, barrelDir)[doc];
+// How many threads one query may use
+struct QueryParallelism {
+    unsigned threads = 1;          // workers per query (0: one per core); 1 is always serial
+    uint64_t minPostings = 1u << 18; // below this many postings over all its lists, a query stays serial
+};
+
+std::vector<SearchResult> rankPartitioned(
+    std::pmr::vector<PostingCursor>& cursors,
+    const std::pmr::vector<uint32_t>& costs,
+    const std::pmr::vector<float>& idfs,
+    const BM25& model,
+    float semantic,
+    size_t k,
+    QueryMode mode,
+    unsigned threads)
+{
+    std::pmr::memory_resource* mem = cursors.get_allocator().resource();
+    const uint32_t NO_DOC = std::numeric_limits<uint32_t>::max();
+
+    size_t guide = 0;
+    for (size_t i = 1; i < cursors.size(); ++i) {
+        bool better = (mode == QueryMode::And) ? costs[i] < costs[guide]
+                                               : cursors[i].size() > cursors[guide].size();
+        if (better) guide = i;
+    }
+    std::pmr::vector<uint32_t> bounds(mem);
+    bounds.push_back(0);
+    cursors[guide].splitPoints(threads, bounds);
+    size_t ranges = bounds.size();
+    if (ranges == 1) return rankRange(cursors, costs, idfs, model, semantic, k, mode); // too short to split
+    bounds.push_back(NO_DOC);
+
+    // List bounds once here, rather than in every worker's copy
+    if (mode != QueryMode::And)
+        for (PostingCursor& c : cursors) c.maxFreq();
+
+    std::vector<std::vector<SearchResult>> ranked(ranges);
+    parallelFor(ranges, static_cast<unsigned>(ranges), [&](size_t r) {
+        QueryScratch::Scope scope; // the worker thread's own arena
+        std::pmr::vector<PostingCursor> local(scope.memory());
+        local.reserve(cursors.size());
+        for (const PostingCursor& c : cursors) {
+            local.push_back(c);
+            local.back().advance(bounds[r]);
+        }
+        std::pmr::vector<uint32_t> localCosts(costs.begin(), costs.end(), scope.memory());
+        std::pmr::vector<float> localIDFs(idfs.begin(), idfs.end(), scope.memory());
+        ranked[r] = rankRange(local, localCosts, localIDFs, model, semantic, k, mode, bounds[r + 1]);
+    });
+
+    TopK<SearchResult> top(k, mem);
+    for (const auto& range : ranked)
+        for (const SearchResult& r : range) top.push(r);
+    return top.take();
+}
+
+/**
+ * @brief Evaluates the cursors (one per query word) in the given mode;
+ * on several threads if parallel allows it and the lists hold at least
+ * parallel.minPostings postings.
+ */
+std::vector<SearchResult> rankQuery(
+    std::pmr::vector<PostingCursor>& cursors,
+    const std::pmr::vector<uint32_t>& costs,
+    const std::pmr::vector<float>& idfs,
+    const BM25& model,
+    float semantic,
+    size_t k,
+    QueryMode mode,
+    QueryParallelism parallel = QueryParallelism())
+{
+    unsigned threads = parallel.threads ? parallel.threads : hardwareThreads();
+    if (threads > 1 && !cursors.empty()) {
+        uint64_t postings = 0;
+        for (const PostingCursor& c : cursors) postings += c.size();
+        if (postings >= parallel.minPostings)
+            return rankPartitioned(cursors, costs, idfs, model, semantic, k, mode, threads);
+    }
+    return rankRange(cursors, costs, idfs, model, semantic, k, mode);
+}
+
+// -------------------- PAIR CACHE --------------------
+/**
+ * @brief Records the term pairs of an AND query (lexIDs[i] is the lexID of
+ * cursors[i], -1 if unknown) and, if one of them is cached or hot enough
+ * to be materialized now, points its two cursors at the pair's
+ * intersection and sets their costs to its size (PairCache.hpp). Results
+ * are unchanged: every doc keeps each term's own TF.
+ * @return The pair in use, to be held while the cursors are read; null if none.
+ */
+std::shared_ptr<const PairIntersection> startFromPair(PairCache& pairs,
+                                                      const std::pmr::vector<int>& lexIDs,
+                                                      std::pmr::vector<PostingCursor>& cursors,
+                                                      std::pmr::vector<uint32_t>& costs)
+{
+    const size_t MAX_PAIR_WORDS = 8; // pairs are tracked among the first 8 words
+    size_t n = std::min(lexIDs.size(), MAX_PAIR_WORDS);
+
+    std::shared_ptr<const PairIntersection> best;
+    size_t first = 0, second = 0;
+    bool anyPair = false;
+    uint8_t hottest = 0;
+    size_t hotFirst = 0, hotSecond = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            if (lexIDs[i] < 0 || lexIDs[j] < 0 || lexIDs[i] == lexIDs[j]) continue;
+            anyPair = true;
+            uint64_t key = PairCache::key(lexIDs[i], lexIDs[j]);
+            pairs.record(key);
+
+            // The smallest cached intersection leads
+            if (auto cached = pairs.find(key)) {
+                if (!best || cached->docIDs.size() < best->docIDs.size()) {
+                    best = cached;
+                    first = i;
+                    second = j;
+                }
+            } else if (pairs.hot(key) && pairs.frequency(key) > hottest) {
+                hottest = pairs.frequency(key);
+                hotFirst = i;
+                hotSecond = j;
             }
         }
+    }
+    if (!anyPair) return nullptr;
+    pairs.countQuery(best != nullptr);
+
+    if (!best && hottest > 0) {
+        uint64_t key = PairCache::key(lexIDs[hotFirst], lexIDs[hotSecond]);
+        size_t bound = sizeof(PairIntersection) + 3 * sizeof(uint32_t) *
+                       std::min(cursors[hotFirst].size(), cursors[hotSecond].size());
+        if (pairs.mayAdmit(key, bound)) {
+            best = pairs.insert(materializePair(lexIDs[hotFirst], cursors[hotFirst],
+                                                lexIDs[hotSecond], cursors[hotSecond]));
+            first = hotFirst;
+            second = hotSecond;
+        }
+    }
+    if (!best) return nullptr;
 
-        float semantic = semanticBoost(docTerms, words, lex);
-        float finalScore = baseScore + SEMANTIC_WEIGHT * semantic;
+    cursors[first]  = PostingCursor(best->span(lexIDs[first]));
+    cursors[second] = PostingCursor(best->span(lexIDs[second]));
+    costs[first] = costs[second] = static_cast<uint32_t>(best->docIDs.size());
+    return best;
+}
+
+// Precomputed IDF of every query word, in query order.
+std::pmr::vector<float> termIDFs(const QueryWords& words,
+                                 const TermDictionary& lex,
+                                 const BM25& model)
+{
+    std::pmr::vector<float> idfs(words.get_allocator());
+    idfs.reserve(words.size());
+    for (const auto& w : words) idfs.push_back(model.termIDF(lex.lookup(w)));
+    return idfs;
+}
 
-        ranked.push_back({doc, finalScore});
+// LexID of every query word, -1 if unknown (for the pair cache).
+std::pmr::vector<int> termLexIDs(const QueryWords& words, const TermDictionary& lex)
+{
+    std::pmr::vector<int> lexIDs(words.get_allocator());
+    lexIDs.reserve(words.size());
+    for (const auto& w : words) lexIDs.push_back(lex.lookup(w));
+    return lexIDs;
+}
+
+// DF of a word's term, for ordering conjunctions. Terms without a DF
+// entry fall back to their posting count.
+uint32_t termCost(std::string_view word, const TermDictionary& lex,
+                  const TermStats& stats, const PostingCursor& cursor)
+{
+    int lexID = lex.lookup(word);
+    return lexID >= 0 && stats.hasDF(lexID) ? stats.df(lexID) : cursor.size();
+}
+
+std::pmr::vector<uint32_t> termCosts(const QueryWords& words,
+                                     const TermDictionary& lex,
+                                     const TermStats& stats,
+                                     const std::pmr::vector<PostingCursor>& cursors)
+{
+    std::pmr::vector<uint32_t> costs(words.get_allocator());
+    costs.reserve(words.size());
+    for (size_t i = 0; i < words.size(); ++i)
+        costs.push_back(termCost(words[i], lex, stats, cursors[i]));
+    return costs;
+}
+
+// Fraction of query words known to the lexicon (see semanticBoost()).
+float lexiconCoverage(const QueryWords& words,
+                      const TermDictionary& lex)
+{
+    float count = 0.0f;
+    for (auto& w : words)
+        if (lex.contains(w)) count += 1.0f;
+    return count / (float)words.size();
+}
+
+// -------------------- BOOLEAN QUERIES --------------------
+// Non-negated words of a parsed query, in query order (the words that can
+// contribute to a score).
+void positiveWords(const QueryNode& node, std::vector<std::string>& out)
+{
+    if (node.kind == QueryNode::Term) out.push_back(node.word);
+    if (node.kind == QueryNode::Not) return;
+    for (const auto& c : node.children) positiveWords(c, out);
+}
+
+// Scores every match of the iterator tree like rankIntersection(): the
+// BM25 shares of the non-negated terms present in the doc, plus the
+// semantic boost for the fraction of non-negated words present. A plain
+// "a b" query thus ranks exactly as QueryMode::And.
+std::vector<SearchResult> rankBoolean(QueryIterator& match,
+                                      const BM25& model,
+                                      size_t wordCount,
+                                      size_t k)
+{
+    QueryScratch::Scope scope;
+    TopK<SearchResult> top(k, scope.memory());
+    const float SEMANTIC_WEIGHT = 0.35f;
+
+    for (; !match.atEnd(); match.next()) {
+        uint32_t doc = match.docID();
+        float baseScore = 0.0f;
+        int matched = 0;
+        match.collect(doc, model, baseScore, matched);
+        top.push({(int)doc, baseScore + SEMANTIC_WEIGHT * ((float)matched / (float)wordCount)});
+    }
+    return top.take();
+}
+
+/**
+ * @brief Parses the query if it needs the iterator tree: every
+ * QueryMode::Boolean query, and a QueryMode::And query that quotes a
+ * phrase (parsePhraseQuery(), where AND / OR / NOT stay words).
+ * @return false if the query is left to the token path, as is a
+ *         QueryMode::And query whose quotes do not pair up.
+ * @throws std::invalid_argument if a QueryMode::Boolean query does not parse.
+ */
+bool parseStructuredQuery(const std::string& query, QueryMode mode, QueryNode& root)
+{
+    if (mode == QueryMode::And)
+        return query.find('"') != std::string::npos && parsePhraseQuery(query, root);
+    if (mode != QueryMode::Boolean || query.find_first_not_of(" \t\n\r\f\v") == std::string::npos)
+        return false;
+
+    std::string error;
+    if (!parseQuery(query, root, error)) throw std::invalid_argument(error);
+    return true;
+}
+
+// Result cache key (ResultCache.hpp): mode, k and the tokens, so queries
+// that differ only in case or spacing share an entry. Boolean queries keep
+// their case, since AND / OR / NOT are operators only in upper case.
+std::string queryCacheKey(const std::string& query, size_t k, QueryMode mode)
+{
+    std::string key = std::to_string(static_cast<int>(mode)) + ':' + std::to_string(k) + ':';
+    bool boolean = mode == QueryMode::Boolean;
+    std::stringstream ss(query);
+    std::string t;
+    while (ss >> t) {
+        if (!boolean) std::transform(t.begin(), t.end(), t.begin(), ::tolower);
+        key += t;
+        key += ' ';
     }
+    return key;
+}
 
-    std::sort(ranked.begin(), ranked.end(),
-              [](auto&a, auto&b){ return a.score > b.score; });
+// Evaluates an already parsed boolean query
+std::vector<SearchResult> searchBoolean(const QueryNode& root,
+                                        const TermResolver& resolve,
+                                        const BM25& model,
+                                        size_t k)
+{
+    std::vector<std::string> words;
+    positiveWords(root, words);
 
-    if (ranked.size() > 10)
-        ranked.resize(10);
+    std::unique_ptr<QueryIterator> match = compileQuery(root, resolve);
+    return rankBoolean(*match, model, words.size(), k);
+}
 
-    return ranked;
+// -------------------- SEARCH (MAPPED BARRELS) --------------------
+// No barrel reloads: cursors read the mapped barrel_N.bin files directly.
+std::vector<SearchResult> run_search(
+    const std::string& query,
+    const TermDictionary& lex,
+    const TermStats& stats,
+    const BarrelStore& barrels,
+    const BM25& model,
+    size_t k = DEFAULT_TOP_K,
+    QueryMode mode = QueryMode::And,
+    const PositionIndex* positions = nullptr,
+    PairCache* pairs = nullptr,
+    QueryParallelism parallel = QueryParallelism())
+{
+    QueryNode root;
+    if (parseStructuredQuery(query, mode, root)) {
+        return searchBoolean(root,
+            [&](const std::string& w, TermIterator& t, bool positional) {
+                t.cursor = getPostingCursor(w, lex, stats, barrels, t.scratch);
+                t.df = termCost(w, lex, stats, t.cursor);
+                int lexID = lex.lookup(w);
+                t.idf = model.termIDF(lexID);
+                if (positional && positions && lexID >= 0) t.positions = positions->cursor(lexID);
+            },
+            model, k);
+    }
+
+    QueryScratch::Scope scope;
+    QueryWords words = tokenize(query, scope.memory());
+    if (words.empty()) return {};
+
+    std::pmr::vector<PostingCursor> cursors(scope.memory());
+    cursors.reserve(words.size());
+    for (const auto& w : words)
+        cursors.push_back(getPostingCursor(w, lex, stats, barrels, scope.scratch().decodeBuffer()));
+
+    std::pmr::vector<uint32_t> costs = termCosts(words, lex, stats, cursors);
+    std::shared_ptr<const PairIntersection> pair;
+    if (pairs && mode == QueryMode::And) pair = startFromPair(*pairs, termLexIDs(words, lex), cursors, costs);
+
+    return rankQuery(cursors, costs, termIDFs(words, lex, model), model,
+                     lexiconCoverage(words, lex), k, mode, parallel);
+}
+
+// -------------------- SEARCH (CACHED BARRELS) --------------------
+// Each barrel is decoded at most once per cache lifetime; terms that share
+// a barrel share the decode, and warm queries do no disk I/O.
+std::vector<SearchResult> run_search(
+    const std::string& query,
+    const TermDictionary& lex,
+    const TermStats& stats,
+    const std::string& barrelDir,
+    BarrelCache& cache,
+    const BM25& model,
+    size_t k = DEFAULT_TOP_K,
+    QueryMode mode = QueryMode::And,
+    const PositionIndex* positions = nullptr,
+    PairCache* pairs = nullptr,
+    QueryParallelism parallel = QueryParallelism())
+{
+    QueryScratch::Scope scope;
+
+    // Holding the barrels keeps their spans valid even if evicted meanwhile
+    std::pmr::vector<std::shared_ptr<const DecodedBarrel>> held(scope.memory());
+    auto find = [&](std::string_view w) {
+        int lexID = lex.lookup(w);
+        int barrelID = stats.barrel(lexID);
+        if (barrelID < 0) return PostingSpan{};
+        held.push_back(cache.get(barrelID,
+            [&](int id) { return loadDecodedBarrel(barrelDir, id); }));
+        return held.back()->find(lexID);
+    };
+
+    QueryNode root;
+    if (parseStructuredQuery(query, mode, root)) {
+        return searchBoolean(root,
+            [&](const std::string& w, TermIterator& t, bool positional) {
+                t.cursor = PostingCursor(find(w));
+                t.df = termCost(w, lex, stats, t.cursor);
+                int lexID = lex.lookup(w);
+                t.idf = model.termIDF(lexID);
+                if (positional && positions && lexID >= 0) t.positions = positions->cursor(lexID);
+            },
+            model, k);
+    }
+
+    QueryWords words = tokenize(query, scope.memory());
+    if (words.empty()) return {};
+
+    std::pmr::vector<PostingCursor> cursors(scope.memory());
+    cursors.reserve(words.size());
+
+    for (auto& w : words) cursors.emplace_back(find(w));
+
+    std::pmr::vector<uint32_t> costs = termCosts(words, lex, stats, cursors);
+    std::shared_ptr<const PairIntersection> pair;
+    if (pairs && mode == QueryMode::And) pair = startFromPair(*pairs, termLexIDs(words, lex), cursors, costs);
+
+    return rankQuery(cursors, costs, termIDFs(words, lex, model), model,
+                     lexiconCoverage(words, lex), k, mode, parallel);
+}
+
+// -------------------- SEARCH (INDEX SEGMENT) --------------------
+// Everything comes from the mapped segment: lexicon, DF and postings.
+std::vector<SearchResult> run_search(const std::string& query, const IndexSegment& segment,
+                                     const BM25& model,
+                                     size_t k = DEFAULT_TOP_K, QueryMode mode = QueryMode::And,
+                                     const PositionIndex* positions = nullptr,
+                                     PairCache* pairs = nullptr,
+                                     QueryParallelism parallel = QueryParallelism())
+{
+    QueryNode root;
+    if (parseStructuredQuery(query, mode, root)) {
+        return searchBoolean(root,
+            [&](const std::string& w, TermIterator& t, bool positional) {
+                int lexID = segment.lookup(w);
+                if (lexID < 0) return;
+                t.cursor = segment.cursor(lexID);
+                t.df = segment.meta(lexID)->df;
+                t.idf = model.termIDF(lexID);
+                if (positional && positions) t.positions = positions->cursor(lexID);
+            },
+            model, k);
+    }
+
+    QueryScratch::Scope scope;
+    QueryWords words = tokenize(query, scope.memory());
+    if (words.empty()) return {};
+
+    std::pmr::vector<PostingCursor> cursors(scope.memory());
+    std::pmr::vector<uint32_t> costs(scope.memory());
+    std::pmr::vector<float> idfs(scope.memory());
+    std::pmr::vector<int> lexIDs(scope.memory());
+    cursors.reserve(words.size());
+    costs.reserve(words.size());
+    idfs.reserve(words.size());
+    lexIDs.reserve(words.size());
+
+    for (auto& w : words) {
+        int lexID = segment.lookup(w);
+        if (lexID < 0) {
+            if (mode == QueryMode::And) return {};
+            cursors.emplace_back(); // matches nothing, but still dilutes the boost
+            costs.push_back(0);
+            idfs.push_back(0.0f);
+            lexIDs.push_back(-1);
+            continue;
+        }
+        cursors.push_back(segment.cursor(lexID));
+        costs.push_back(segment.meta(lexID)->df);
+        idfs.push_back(model.termIDF(lexID));
+        lexIDs.push_back(lexID);
+    }
+
+    // Under AND every word is in the lexicon by now, so the semantic boost is 1
+    std::shared_ptr<const PairIntersection> pair;
+    if (pairs && mode == QueryMode::And) pair = startFromPair(*pairs, lexIDs, cursors, costs);
+    return rankQuery(cursors, costs, idfs, model, 1.0f, k, mode, parallel);
+}
+
+// -------------------- BATCH SEARCH --------------------
+// A batch of queries is answered in two phases. First the distinct terms
+// of the whole batch are grouped by barrel (TermStats::barrel(), the
+// barrel map) and each barrel is read once, barrels in parallel: decoded
+// into BarrelCache on the JSON path, each compressed list decoded once on
+// the mapped path, nothing to decode in a segment. Then the queries are
+// evaluated in parallel (Parallel.hpp), each on a copy of the shared
+// cursors it needs and in its thread's QueryScratch.
+
+// A batch query, tokenized or parsed once up front
+struct BatchQuery {
+    std::vector<std::string> words; // the tokens; for a boolean query every word of root
+    bool boolean = false;
+    QueryNode root;
+};
+
+// Every word of a parsed query, negated and phrase words included
+void allWords(const QueryNode& node, std::vector<std::string>& out)
+{
+    if (node.kind == QueryNode::Term) out.push_back(node.word);
+    for (const auto& c : node.children) allWords(c, out);
+}
+
+/**
+ * @brief Tokenizes the query, or parses it (parseStructuredQuery()).
+ * @throws std::invalid_argument if a boolean query does not parse.
+ */
+BatchQuery prepareBatchQuery(const std::string& query, QueryMode mode)
+{
+    BatchQuery q;
+    q.words = tokenize(query);
+    if (q.words.empty() || !parseStructuredQuery(query, mode, q.root)) return q;
+
+    q.boolean = true;
+    q.words.clear();
+    allWords(q.root, q.words);
+    return q;
+}
+
+// One term's postings, fetched once for the whole batch
+struct BatchTerm {
+    PostingCursor cursor; // never advanced; each query walks a copy
+    uint32_t df = 0;      // conjunction cost, as termCost()
+};
+
+// Read-only once fetched, so queries share it across threads
+struct BatchPostings {
+    std::unordered_map<int, BatchTerm> terms;                // by lexID
+    std::vector<std::shared_ptr<const DecodedBarrel>> held;  // barrels the cursors point into
+    std::vector<BarrelPostings> decoded;                     // decoded lists of mapped barrels
+
+    const BatchTerm* find(int lexID) const {
+        auto it = terms.find(lexID);
+        return it == terms.end() ? nullptr : &it->second;
+    }
+};
+
+// Indices into lexIDs grouped by barrel, ascending barrelID; lexIDs
+// without a barrel are left out
+std::vector<std::vector<size_t>> groupByBarrel(const std::vector<int>& lexIDs, const TermStats& stats)
+{
+    std::map<int, std::vector<size_t>> byBarrel;
+    for (size_t i = 0; i < lexIDs.size(); ++i) {
+        int barrelID = stats.barrel(lexIDs[i]);
+        if (barrelID >= 0) byBarrel[barrelID].push_back(i);
+    }
+    std::vector<std::vector<size_t>> groups;
+    groups.reserve(byBarrel.size());
+    for (auto& [barrelID, group] : byBarrel) groups.push_back(std::move(group));
+    return groups;
+}
+
+// Mapped barrels: compressed lists are decoded once, into batch.decoded
+BatchPostings fetchBatch(const std::vector<int>& lexIDs, const TermStats& stats,
+                         const BarrelStore& barrels, unsigned threads = 0)
+{
+    BatchPostings batch;
+    batch.decoded.resize(lexIDs.size()); // sized once: the cursors point into it
+    std::vector<BatchTerm> fetched(lexIDs.size());
+    std::vector<std::vector<size_t>> groups = groupByBarrel(lexIDs, stats);
+
+    parallelFor(groups.size(), threads, [&](size_t g) {
+        for (size_t i : groups[g]) {
+            int lexID = lexIDs[i];
+            fetched[i].cursor = barrels.cursor(stats.barrel(lexID), lexID, batch.decoded[i]);
+            fetched[i].df = stats.hasDF(lexID) ? stats.df(lexID) : fetched[i].cursor.size();
+        }
+    });
+
+    for (const auto& group : groups)
+        for (size_t i : group) batch.terms.emplace(lexIDs[i], fetched[i]);
+    return batch;
+}
+
+// JSON / unmapped barrels: cached barrels are reused, the missing ones
+// decoded in parallel and then cached
+BatchPostings fetchBatch(const std::vector<int>& lexIDs, const TermStats& stats,
+                         const std::string& barrelDir, BarrelCache& cache, unsigned threads = 0)
+{
+    BatchPostings batch;
+    std::vector<std::vector<size_t>> groups = groupByBarrel(lexIDs, stats);
+    auto barrelOf = [&](size_t g) { return stats.barrel(lexIDs[groups[g].front()]); };
+
+    batch.held.resize(groups.size());
+    std::vector<size_t> missing;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        batch.held[g] = cache.find(barrelOf(g));
+        if (!batch.held[g]) missing.push_back(g);
+    }
+
+    parallelFor(missing.size(), threads, [&](size_t m) {
+        size_t g = missing[m];
+        batch.held[g] = std::make_shared<const DecodedBarrel>(loadDecodedBarrel(barrelDir, barrelOf(g)));
+    });
+    for (size_t g : missing) cache.insert(barrelOf(g), batch.held[g]);
+
+    for (size_t g = 0; g < groups.size(); ++g) {
+        for (size_t i : groups[g]) {
+            BatchTerm term;
+            term.cursor = PostingCursor(batch.held[g]->find(lexIDs[i]));
+            term.df = stats.hasDF(lexIDs[i]) ? stats.df(lexIDs[i]) : term.cursor.size();
+            batch.terms.emplace(lexIDs[i], term);
+        }
+    }
+    return batch;
+}
+
+// Index segment: postings are read in place, only the lookups are shared
+BatchPostings fetchBatch(const std::vector<int>& lexIDs, const IndexSegment& segment)
+{
+    BatchPostings batch;
+    for (int lexID : lexIDs) {
+        const TermMeta* meta = segment.meta(lexID);
+        if (!meta) continue;
+        batch.terms.emplace(lexID, BatchTerm{segment.cursor(lexID), meta->df});
+    }
+    return batch;
+}
+
+/**
+ * @brief Evaluates one prepared query over the batch's postings; ranks
+ * exactly as the run_search() of the source they were fetched from
+ * (lex is that source's dictionary). Safe to call from several threads.
+ */
+std::vector<SearchResult> run_search(const BatchQuery& query,
+                                     const TermDictionary& lex,
+                                     const BatchPostings& batch,
+                                     const BM25& model,
+                                     size_t k = DEFAULT_TOP_K,
+                                     QueryMode mode = QueryMode::And,
+                                     const PositionIndex* positions = nullptr)
+{
+    if (query.words.empty()) return {};
+
+    if (query.boolean) {
+        return searchBoolean(query.root,
+            [&](const std::string& w, TermIterator& t, bool positional) {
+                int lexID = lex.lookup(w);
+                if (const BatchTerm* term = batch.find(lexID)) {
+                    t.cursor = term->cursor;
+                    t.df = term->df;
+                }
+                t.idf = model.termIDF(lexID);
+                if (positional && positions && lexID >= 0) t.positions = positions->cursor(lexID);
+            },
+            model, k);
+    }
+
+    QueryScratch::Scope scope;
+    std::pmr::vector<PostingCursor> cursors(scope.memory());
+    std::pmr::vector<uint32_t> costs(scope.memory());
+    std::pmr::vector<float> idfs(scope.memory());
+    cursors.reserve(query.words.size());
+    costs.reserve(query.words.size());
+    idfs.reserve(query.words.size());
+
+    float known = 0.0f; // for the semantic boost, as lexiconCoverage()
+    for (const auto& w : query.words) {
+        int lexID = lex.lookup(w);
+        const BatchTerm* term = batch.find(lexID);
+        cursors.push_back(term ? term->cursor : PostingCursor());
+        costs.push_back(term ? term->df : 0);
+        idfs.push_back(model.termIDF(lexID));
+        if (lexID >= 0) known += 1.0f;
+    }
+    return rankQuery(cursors, costs, idfs, model, known / (float)query.words.size(), k, mode);
 }
 
 // // -------------------- MAIN --------------------
@@ -367,7 +1439,7 @@ std::vector<SearchResult> run_search(
 
 //         if (line.substr(0,4) == "add ") {
 //             std::string content = line.substr(4);
-//             addDocument(++lastDocID, content, lex, df, map, barrels_dir);
+//             addDocument(++lastDocID, content, lex, df, map, barrels_dir, argv[1], argv[2], argv[3]);
 //         } else if (line.substr(0,7) == "search ") {
 //             std::string query = line.substr(7);
 //             auto t1 = std::chrono::high_resolution_clock::now();
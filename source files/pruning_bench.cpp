@@ -0,0 +1,215 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include "LumiEngine.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Ranked-OR benchmark: WAND, Block-Max WAND and MaxScore against scoring
+// every posting (scoreExhaustive), with the scorer rankDisjunction() uses
+// (BM25 plus the semantic share per matched word).
+// Queries of 2..10 terms are drawn from the index, terms weighted by DF so
+// common words show up as they do in real queries. Every evaluator must
+// return exactly the exhaustive top k.
+//
+//   pruning_bench <lumi.seg> [queries_per_length=50] [k=10]
+//   pruning_bench --synthetic <docs> [queries_per_length=50] [k=10]
+//
+// --synthetic builds a Zipf-distributed in-memory index of block lists
+// instead, for corpora larger than the one at hand, with log-normal
+// document lengths. A segment is scored with the doc_lengths.bin next to
+// it, if any.
+//
+// Before either, checkZeroLengthBound() runs the evaluators on a small
+// fixed index where a document has a 0 length entry.
+
+// One term of the benchmark index
+struct BenchTerm {
+    std::function<PostingCursor()> cursor;
+    uint32_t df;
+};
+
+std::vector<BenchTerm> segmentTerms(const IndexSegment& segment) {
+    std::vector<BenchTerm> terms;
+    const TermDictionary& dict = segment.dictionary();
+    for (uint32_t i = 0; i < dict.size(); ++i) {
+        int lexID = dict.lexID(i);
+        const TermMeta* m = segment.meta(lexID);
+        if (!m || m->postingCount == 0) continue;
+        terms.push_back({[&segment, lexID] { return segment.cursor(lexID); }, m->df});
+    }
+    return terms;
+}
+
+std::vector<BenchTerm> syntheticTerms(uint32_t docs, std::vector<std::vector<uint8_t>>& storage,
+                                      std::mt19937& rng)
+{
+    const uint32_t VOCABULARY = 2000;
+    std::vector<BenchTerm> terms;
+    storage.resize(VOCABULARY);
+    std::geometric_distribution<uint32_t> extra(0.6);
+
+    for (uint32_t t = 0; t < VOCABULARY; ++t) {
+        double density = std::min(0.3, 0.3 / std::pow(t + 1.0, 0.9));
+        std::bernoulli_distribution has(density);
+        std::vector<uint32_t> docIDs, freqs;
+        for (uint32_t d = 0; d < docs; ++d)
+            if (has(rng)) { docIDs.push_back(d); freqs.push_back(1 + std::min(extra(rng), 20u)); }
+        if (docIDs.empty()) continue;
+
+        encodeBlockPostings(docIDs.data(), freqs.data(), docIDs.size(), storage[t]);
+        const uint8_t* data = storage[t].data();
+        size_t bytes = storage[t].size();
+        uint32_t n = static_cast<uint32_t>(docIDs.size());
+        terms.push_back({[data, bytes, n] { return PostingCursor::fromBlocks(data, bytes, n); }, n});
+    }
+    return terms;
+}
+
+// The same result lists, scores included
+bool sameResults(const std::vector<SearchResult>& a, const std::vector<SearchResult>& b) {
+    bool same = a.size() == b.size();
+    for (size_t i = 0; same && i < a.size(); ++i)
+        same = a[i].docID == b[i].docID && a[i].score == b[i].score;
+    return same;
+}
+
+// A 0 entry in the length column (a document added after indexing) must
+// score within termBound() like any other. Of 10000 documents of one
+// length, doc 0 holds both query terms once and doc 50, without a length,
+// holds the first one 20 times. Once doc 0 sets the threshold, doc 50 can
+// only be reached if its score stays under the first term's bound.
+bool checkZeroLengthBound()
+{
+    std::vector<uint32_t> lens(10000, 100);
+    lens[50] = 0;
+    std::vector<uint32_t> aDocs{0, 50}, aFreqs{1, 20}, bDocs{0}, bFreqs{1};
+    std::vector<uint8_t> a, b;
+    encodeBlockPostings(aDocs.data(), aFreqs.data(), aDocs.size(), a);
+    encodeBlockPostings(bDocs.data(), bFreqs.data(), bDocs.size(), b);
+
+    DocLengths lengths;
+    lengths.assign(DocLengths::build(lens));
+    BM25 model;
+    model.configure(&lengths, static_cast<uint32_t>(lens.size()), BM25Params());
+    std::pmr::vector<float> idfs{model.idf(2), model.idf(1)};
+    std::pmr::vector<TermScorer> scorers = disjunctionScorers(idfs, model);
+
+    auto run = [&](int which) {
+        std::pmr::vector<PostingCursor> cursors{PostingCursor::fromBlocks(a.data(), a.size(), 2),
+                                                PostingCursor::fromBlocks(b.data(), b.size(), 1)};
+        if (which == 0) return scoreExhaustive<SearchResult>(cursors, scorers, 1);
+        if (which == 1) return wandSearch<SearchResult>(cursors, scorers, 1, false);
+        if (which == 2) return wandSearch<SearchResult>(cursors, scorers, 1, true);
+        return maxScoreSearch<SearchResult>(cursors, scorers, 1);
+    };
+    std::vector<SearchResult> expected = run(0);
+    for (int which = 1; which < 4; ++which) {
+        if (!sameResults(run(which), expected)) {
+            std::cerr << "ERROR: Evaluator " << which << " differs from exhaustive scoring with a 0 document length\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cout << "Usage: pruning_bench <lumi.seg> [queries_per_length=50] [k=10]\n"
+                  << "       pruning_bench --synthetic <docs> [queries_per_length=50] [k=10]\n";
+        return 1;
+    }
+
+    if (!checkZeroLengthBound()) return 1;
+
+    std::mt19937 rng(42);
+    IndexSegment segment;
+    std::vector<std::vector<uint8_t>> storage;
+    std::vector<BenchTerm> terms;
+    DocLengths lengths;
+    uint32_t totalDocs = TOTAL_DOCUMENTS;
+    int arg = 2;
+
+    if (std::string(argv[1]) == "--synthetic") {
+        if (argc < 3) { std::cerr << "ERROR: --synthetic needs a document count\n"; return 1; }
+        totalDocs = static_cast<uint32_t>(std::stoul(argv[2]));
+        terms = syntheticTerms(totalDocs, storage, rng);
+
+        std::lognormal_distribution<float> docLength(5.0f, 1.0f);
+        std::vector<uint32_t> lens(totalDocs);
+        for (auto& len : lens) len = 1 + static_cast<uint32_t>(docLength(rng));
+        lengths.assign(DocLengths::build(lens));
+        arg = 3;
+    } else {
+        if (!segment.open(argv[1])) return 1;
+        terms = segmentTerms(segment);
+        fs::path dir = fs::path(argv[1]).parent_path();
+        lengths.open(docLengthsPath(dir.empty() ? "." : dir.string()));
+    }
+
+    BM25 model;
+    model.configure(&lengths, totalDocs, BM25Params());
+    int perLength = (argc > arg) ? std::max(1, std::stoi(argv[arg])) : 50;
+    size_t k = (argc > arg + 1) ? std::stoul(argv[arg + 1]) : DEFAULT_TOP_K;
+
+    if (terms.empty()) { std::cerr << "ERROR: Index has no postings\n"; return 1; }
+
+    // Terms drawn in proportion to their DF
+    std::vector<double> weights;
+    for (auto& t : terms) weights.push_back(t.df);
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+    std::cout << terms.size() << " terms, " << perLength << " queries per length, k = " << k
+              << " (ms per query)\n\n";
+    std::cout << std::left << std::setw(7) << "terms" << std::right
+              << std::setw(12) << "exhaustive" << std::setw(10) << "wand" << std::setw(10) << "bmw"
+              << std::setw(10) << "maxscore" << std::setw(10) << "best" << "\n";
+
+    for (size_t length = 2; length <= 10; ++length) {
+        double totals[4] = {0, 0, 0, 0};
+
+        for (int q = 0; q < perLength; ++q) {
+            std::vector<size_t> query;
+            for (size_t i = 0; i < length; ++i) query.push_back(pick(rng));
+
+            std::pmr::vector<float> idfs;
+            for (size_t t : query) idfs.push_back(model.idf(terms[t].df));
+            std::pmr::vector<TermScorer> scorers = disjunctionScorers(idfs, model);
+
+            auto run = [&](int which) {
+                std::pmr::vector<PostingCursor> cursors;
+                for (size_t t : query) cursors.push_back(terms[t].cursor());
+                auto t1 = Clock::now();
+                std::vector<SearchResult> r;
+                if (which == 0) r = scoreExhaustive<SearchResult>(cursors, scorers, k);
+                if (which == 1) r = wandSearch<SearchResult>(cursors, scorers, k, false);
+                if (which == 2) r = wandSearch<SearchResult>(cursors, scorers, k, true);
+                if (which == 3) r = maxScoreSearch<SearchResult>(cursors, scorers, k);
+                totals[which] += std::chrono::duration<double, std::milli>(Clock::now() - t1).count();
+                return r;
+            };
+
+            std::vector<SearchResult> expected = run(0);
+            for (int which = 1; which < 4; ++which) {
+                if (!sameResults(run(which), expected)) {
+                    std::cerr << "ERROR: Evaluator " << which << " differs from exhaustive scoring on a "
+                              << length << "-term query\n";
+                    return 1;
+                }
+            }
+        }
+
+        double best = std::min({totals[1], totals[2], totals[3]});
+        std::cout << std::left << std::setw(7) << length << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << totals[0] / perLength << std::setw(10) << totals[1] / perLength
+                  << std::setw(10) << totals[2] / perLength << std::setw(10) << totals[3] / perLength
+                  << std::setw(9) << std::setprecision(1) << totals[0] / best << "x\n";
+    }
+    return 0;
+}
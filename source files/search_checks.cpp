@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "LumiEngine.hpp"
+
+// -------------------- SEARCH CHECKS --------------------
+// Query-syntax checks against a real index; exits non-zero on a failure.
+// wordA / wordB should be two indexed words that occur together.
+//
+//   search_checks <lexicon.json> <barrel_map.json> <df_map.json> <barrels_dir> <wordA> <wordB>
+//
+// Under QueryMode::And only a query whose quotes pair up is parsed:
+//   - an unbalanced quote ("he said \"hi", a lone "\"") is plain tokens
+//     and must not throw,
+//   - upper-case OR / NOT and "-word" are words, not operators, even in
+//     a query with a phrase,
+//   - a quoted phrase matches a subset of the same words ANDed.
+// QueryMode::Boolean still rejects an unbalanced quote.
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "✅ " : "❌ ") << what << "\n";
+    if (!ok) failures++;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 7) {
+        std::cout << "Usage: search_checks <lexicon.json> <barrel_map.json> <df_map.json> <barrels_dir> <wordA> <wordB>\n";
+        return 1;
+    }
+    LumiEngine engine(argv[1], argv[2], argv[3], argv[4]);
+    std::string a = argv[5], b = argv[6];
+
+    auto noThrow = [&](const std::string& query) {
+        try {
+            engine.searchUncached(query);
+            return true;
+        } catch (const std::exception& e) {
+            std::cout << "   " << e.what() << "\n";
+            return false;
+        }
+    };
+    check(noThrow("he said \"hi"), "unbalanced quote does not throw under AND");
+    check(noThrow("\""), "lone quote does not throw under AND");
+    check(noThrow(a + " \"" + b), "open quote before a word does not throw under AND");
+
+    // With a phrase the query is parsed, yet the operators stay words: ANDed
+    // with the unindexed "zzqx" they match nothing (as operators, the
+    // phrase's matches would come back)
+    std::string quoted = "\"" + a + " " + b + "\"";
+    check(engine.searchUncached(quoted + " OR zzqx").empty(), "upper-case OR is a word under AND");
+    check(engine.searchUncached(quoted + " NOT zzqx").empty(), "upper-case NOT is a word under AND");
+    check(engine.searchUncached(quoted + " -zzqx").empty(), "-word is a word under AND");
+
+    std::vector<SearchResult> both = engine.searchUncached(a + " " + b, SIZE_MAX);
+    std::vector<SearchResult> phrase = engine.searchUncached(quoted, SIZE_MAX);
+    bool subset = phrase.size() <= both.size();
+    for (const auto& r : phrase)
+        subset = subset && std::any_of(both.begin(), both.end(),
+                                       [&](const SearchResult& x) { return x.docID == r.docID; });
+    check(subset, "phrase matches a subset of its words ANDed (" + std::to_string(phrase.size()) +
+                  " of " + std::to_string(both.size()) + ")");
+
+    bool rejected = false;
+    try {
+        engine.searchUncached(a + " \"" + b, DEFAULT_TOP_K, QueryMode::Boolean);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    check(rejected, "unbalanced quote is a syntax error under Boolean");
+
+    std::cout << (failures == 0 ? "✅ All search checks passed" : "❌ Search checks failed") << "\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <algorithm>
 #include "nlohmann/json.hpp"
+#include "BarrelSidecar.hpp"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
@@ -146,18 +147,30 @@ void singleWordSearch(
 
     std::cout << "✓ Barrel: " << barrelID << "\n";
 
-    // Step 3: Load only required barrel
-    json barrel = loadBarrelFile(barrelDir, barrelID);
+    // Step 3 + 4: Retrieve posting list. With a sidecar (barrel_N.idx)
+    // only this word's slice is read and parsed; otherwise load the barrel.
+    json postingList;
+    std::string slice;
+    std::string barrelFile = barrelDir + "/barrel_" + std::to_string(barrelID) + ".json";
 
-    std::string wordKey = std::to_string(wordID);
+    if(readBarrelSlice(barrelFile, barrelSidecarPath(barrelDir, barrelID), wordID, slice)){
+        if(slice.empty()){
+            std::cout << "❌ Word not present in barrel\n";
+            return;
+        }
+        postingList = json::parse(slice);
+    } else {
+        json barrel = loadBarrelFile(barrelDir, barrelID);
 
-    // Step 4: Retrieve posting list
-    if(!barrel.contains(wordKey)){
-        std::cout << "❌ Word not present in barrel\n";
-        return;
-    }
+        std::string wordKey = std::to_string(wordID);
 
-    json postingList = barrel[wordKey];
+        if(!barrel.contains(wordKey)){
+            std::cout << "❌ Word not present in barrel\n";
+            return;
+        }
+
+        postingList = barrel[wordKey];
+    }
 
     // Step 5: Display results
     std::cout << "\n🔍 RESULTS:\n";
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include "LumiEngine.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Cold-start benchmark for LumiEngine's constructor: the old nlohmann DOM
+// loaders against the JSON scanner, plus the binary artifacts
+// (.dict / term_stats.bin / lumi.seg) when they are given.
+// Files are read once before timing, so this measures parsing and
+// building, not the disk.
+
+// -------------------- DOM LOADERS (previous constructor) --------------------
+std::unordered_map<std::string, int> loadLexiconDOM(const std::string& file) {
+    std::ifstream fin(file);
+    json j; fin >> j;
+    std::unordered_map<std::string, int> lex;
+    auto& items = j.contains("lexicon") ? j["lexicon"] : j;
+    for (auto& [word, val] : items.items())
+        lex[word] = val.is_array() ? val[0].get<int>() : val.get<int>();
+    return lex;
+}
+
+std::unordered_map<int, int> loadIntMapDOM(const std::string& file) {
+    std::ifstream fin(file);
+    json j; fin >> j;
+    std::unordered_map<int, int> map;
+    for (auto& [key, val] : j.items())
+        map[std::stoi(key)] = val.is_array() ? val[0].get<int>() : val.get<int>();
+    return map;
+}
+
+// Median wall time of fn over repeats runs
+double medianMs(int repeats, const std::function<void()>& fn) {
+    std::vector<double> times;
+    for (int r = 0; r < repeats; ++r) {
+        auto t1 = Clock::now();
+        fn();
+        auto t2 = Clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(t2 - t1).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 5) {
+        std::cout << "Usage: startup_bench <lexicon.json> <barrel_map.json> <df_map.json> <barrels_dir> "
+                  << "[repeats=5] [--dict lexicon.dict] [--stats term_stats.bin] [--segment lumi.seg]\n";
+        return 1;
+    }
+
+    std::string lexFile = argv[1], mapFile = argv[2], dfFile = argv[3], barrelsDir = argv[4];
+    int repeats = 5;
+    std::string dictFile, statsFile, segmentFile;
+    for (int i = 5; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dict" && i + 1 < argc) dictFile = argv[++i];
+        else if (arg == "--stats" && i + 1 < argc) statsFile = argv[++i];
+        else if (arg == "--segment" && i + 1 < argc) segmentFile = argv[++i];
+        else repeats = std::max(1, std::stoi(arg));
+    }
+
+    // Warm the page cache so every row parses from memory
+    for (const auto& f : {lexFile, mapFile, dfFile}) { JsonFile warm; warm.open(f); warm.cursor().skip(); }
+
+    std::cout << "Median of " << repeats << " runs\n\n";
+    std::cout << "constructor                    ms\n";
+    auto row = [](const char* name, double ms) {
+        std::cout << std::left << std::setw(26) << name << std::right
+                  << std::setw(10) << std::fixed << std::setprecision(2) << ms << "\n";
+    };
+
+    // What the constructor did before: three DOM parses, then the same
+    // dictionary / stats build the engine does now
+    double domMs = medianMs(repeats, [&] {
+        TermDictionary lex;
+        lex.assign(TermDictionary::build(loadLexiconDOM(lexFile)));
+        TermStats stats;
+        stats.assign(TermStats::build(loadIntMapDOM(mapFile), loadIntMapDOM(dfFile), TOTAL_DOCUMENTS));
+        BarrelStore barrels;
+        barrels.open(barrelsDir);
+    });
+    row("json (nlohmann DOM)", domMs);
+
+    double scanMs = medianMs(repeats, [&] { LumiEngine engine(lexFile, mapFile, dfFile, barrelsDir); });
+    row("json (scanner)", scanMs);
+
+    if (!dictFile.empty() && !statsFile.empty()) {
+        double binMs = medianMs(repeats, [&] { LumiEngine engine(dictFile, statsFile, "", barrelsDir); });
+        row(".dict + term_stats.bin", binMs);
+    }
+    if (!segmentFile.empty()) {
+        double segMs = medianMs(repeats, [&] { LumiEngine engine(segmentFile); });
+        row("lumi.seg", segMs);
+    }
+
+    std::cout << "\nScanner speedup over DOM: " << std::setprecision(2) << domMs / scanMs << "x\n";
+    return 0;
+}